@@ -0,0 +1,20 @@
+-- Upgrades a database created by an older version to the schema of
+-- confi.sql; run it once, before using the new version.
+
+-- revisions, for zak_confi_get_changes_since()
+ALTER TABLE configs ADD COLUMN revision bigint DEFAULT 0;
+ALTER TABLE "values" ADD COLUMN revision bigint DEFAULT 0;
+
+CREATE INDEX values_revision ON "values" (id_configs, revision);
+
+CREATE TABLE values_removed (
+    id_configs integer NOT NULL,
+    path text NOT NULL,
+    revision bigint DEFAULT 0
+);
+
+CREATE INDEX values_removed_revision ON values_removed (id_configs, revision);
+
+-- the key ids are reserved in blocks from configs.next_id; the first
+-- reservation starts after the ids already used
+ALTER TABLE configs ADD COLUMN next_id integer DEFAULT 1;
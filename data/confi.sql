@@ -2,6 +2,8 @@ CREATE TABLE configs (
     id integer NOT NULL,
     name varchar(100) DEFAULT '',
     description varchar(255) DEFAULT '',
+    revision bigint DEFAULT 0,
+    next_id integer DEFAULT 1,
     CONSTRAINT configs_pkey PRIMARY KEY (id),
     CONSTRAINT name_unique UNIQUE (name)
 );
@@ -13,6 +15,17 @@ CREATE TABLE "values" (
     "key" varchar(50) DEFAULT '',
     value text DEFAULT '',
     description varchar(255) DEFAULT '',
+    revision bigint DEFAULT 0,
     CONSTRAINT values_pkey PRIMARY KEY (id_configs, id),
     CONSTRAINT values_name_unique UNIQUE (id_configs, id_parent, "key")
 );
+
+CREATE INDEX values_revision ON "values" (id_configs, revision);
+
+CREATE TABLE values_removed (
+    id_configs integer NOT NULL,
+    path text NOT NULL,
+    revision bigint DEFAULT 0
+);
+
+CREATE INDEX values_removed_revision ON values_removed (id_configs, revision);
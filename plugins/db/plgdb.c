@@ -40,17 +40,238 @@
 
 static void zak_confi_pluggable_iface_init (ZakConfiPluggableInterface *iface);
 
+typedef struct _ZakConfiDBConnection ZakConfiDBConnection;
+
+static ZakConfiDBConnection *zak_confi_db_plugin_pool_acquire (const gchar *cnc_string, guint max);
+static void zak_confi_db_plugin_pool_release (const gchar *cnc_string, ZakConfiDBConnection *cnc);
+static gboolean zak_confi_db_plugin_transaction_end (ZakConfiPluggable *pluggable, gboolean commit);
+static gboolean zak_confi_db_plugin_provider_has_recursive_cte (const gchar *provider);
+static GdaDataModel *zak_confi_db_plugin_select (ZakConfiPluggable *pluggable, GdaStatement *stmt, GdaSet *params);
+static gint zak_confi_db_plugin_execute (ZakConfiPluggable *pluggable, GdaStatement *stmt, GdaSet *params);
+static GdaStatement *zak_confi_db_plugin_get_statement (ZakConfiPluggable *pluggable, guint stmt, GdaSet **params);
+static void zak_confi_db_plugin_set_param_string (GdaSet *params, const gchar *name, const gchar *value);
+static GdaStatement *zak_confi_db_plugin_prepare (ZakConfiPluggable *pluggable, const gchar *sql, GdaSet **params);
 static GdaDataModel *zak_confi_db_plugin_path_get_data_model (ZakConfiPluggable *pluggable, const gchar *path);
+static GdaDataModel *zak_confi_db_plugin_path_get_data_model_full (ZakConfiPluggable *pluggable, const gchar *path, gboolean quiet);
 static gchar *zak_confi_db_plugin_path_get_value_from_db (ZakConfiPluggable *pluggable, const gchar *path);
-static void zak_confi_db_plugin_get_children (ZakConfiPluggable *pluggable, GNode *parentNode, gint idParent, gchar *path);
+static void zak_confi_db_plugin_prepared_destroy (gpointer data);
+static gint64 zak_confi_db_plugin_get_revision (ZakConfiPluggable *pluggable);
+static GdaDataModel *zak_confi_db_plugin_path_query (ZakConfiPluggable *pluggable, const gchar *path, gboolean probe, gboolean quiet, guint *skip, guint *depth);
+static void zak_confi_db_plugin_get_children (ZakConfiPluggable *pluggable, GNode *parentNode, gint idParent, const gchar *path);
 
 #define ZAK_CONFI_DB_PLUGIN_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE ((obj), ZAK_CONFI_TYPE_DB_PLUGIN, ZakConfiDBPluginPrivate))
 
+/* the fixed set of statements, prepared once per connection;
+ * identifiers are quoted with '"' and requoted for the provider */
+enum
+{
+	STMT_CONFIG_BY_NAME,
+	STMT_CONFIG_SET_NAME,
+	STMT_CONFIG_SET_DESCRIPTION,
+	STMT_CONFIG_DELETE,
+	STMT_CONFIGS_LIST,
+	STMT_CONFIGS_LIST_FILTER,
+	STMT_KEY_BY_PARENT,
+	STMT_KEYS_ALL,
+	STMT_KEY_SET_VALUE,
+	STMT_KEY_SET_KEY,
+	STMT_KEY_INSERT,
+	STMT_KEYS_DELETE_ALL,
+	STMT_CONFIG_RESERVE_IDS,
+	STMT_CONFIG_NEXT_ID,
+	STMT_CONFIG_REVISION,
+	STMT_CONFIG_BUMP_REVISION,
+	STMT_KEYS_CHANGED,
+	STMT_KEY_REMOVED,
+	STMT_KEYS_REMOVED_SINCE,
+	STMT_KEYS_REMOVED_DELETE_ALL,
+	STMT_KEYS_BRANCH,
+	STMT_KEYS_PATHS,
+	STMT_KEYS_PATHS_C,
+	STMT_KEY_VALUE_BY_ID,
+	STMT_KEYS_DELETE_BRANCH,
+	STMT_KEYS_TOUCH_BRANCH,
+	STMT_KEY_BY_ID,
+	STMT_KEYS_REMOVED_PRUNE,
+	STMT_N
+};
+
+/* the keys under a prefix with their paths; only with WITH RECURSIVE */
+#define ZAK_CONFI_DB_PLUGIN_SQL_KEYS_PATHS "WITH RECURSIVE branch (id, path) AS (" \
+                                           "SELECT id, CAST(##prefix::string || \"key\" AS text) FROM \"values\"" \
+                                           " WHERE id_configs = ##id_configs::gint" \
+                                           " AND id_parent = ##id_parent::gint" \
+                                           " UNION ALL" \
+                                           " SELECT v.id, CAST(b.path || '/' || v.\"key\" AS text) FROM \"values\" v, branch b" \
+                                           " WHERE v.id_configs = ##id_configs::gint" \
+                                           " AND v.id_parent = b.id)" \
+                                           " SELECT b.path, v.value FROM \"values\" v, branch b" \
+                                           " WHERE v.id_configs = ##id_configs::gint" \
+                                           " AND v.id = b.id" \
+                                           " ORDER BY b.path"
+
+static const gchar *zak_confi_db_plugin_sql[STMT_N] =
+{
+	[STMT_CONFIG_BY_NAME] = "SELECT id, name FROM configs"
+	                        " WHERE name = ##name::string",
+	[STMT_CONFIG_SET_NAME] = "UPDATE configs SET name = ##name::string"
+	                         " WHERE id = ##id_configs::gint",
+	[STMT_CONFIG_SET_DESCRIPTION] = "UPDATE configs SET description = ##description::string::null"
+	                                " WHERE id = ##id_configs::gint",
+	[STMT_CONFIG_DELETE] = "DELETE FROM configs WHERE id = ##id_configs::gint",
+	[STMT_CONFIGS_LIST] = "SELECT * FROM configs",
+	[STMT_CONFIGS_LIST_FILTER] = "SELECT * FROM configs WHERE name LIKE ##filter::string",
+	[STMT_KEY_BY_PARENT] = "SELECT * FROM \"values\""
+	                       " WHERE id_configs = ##id_configs::gint"
+	                       " AND id_parent = ##id_parent::gint"
+	                       " AND \"key\" = ##key::string",
+	[STMT_KEYS_ALL] = "SELECT * FROM \"values\""
+	                  " WHERE id_configs = ##id_configs::gint"
+	                  " ORDER BY id",
+	[STMT_KEY_SET_VALUE] = "UPDATE \"values\" SET value = ##value::string::null,"
+	                       " revision = (SELECT revision FROM configs WHERE id = ##id_configs::gint)"
+	                       " WHERE id_configs = ##id_configs::gint"
+	                       " AND id = ##id::gint",
+	[STMT_KEY_SET_KEY] = "UPDATE \"values\" SET \"key\" = ##key::string,"
+	                     " value = ##value::string::null,"
+	                     " description = ##description::string::null,"
+	                     " revision = (SELECT revision FROM configs WHERE id = ##id_configs::gint)"
+	                     " WHERE id_configs = ##id_configs::gint"
+	                     " AND id = ##id::gint",
+	[STMT_KEY_INSERT] = "INSERT INTO \"values\" (id_configs, id, id_parent, \"key\", value, revision)"
+	                    " VALUES (##id_configs::gint, ##id::gint, ##id_parent::gint, ##key::string, ##value::string::null,"
+	                    " (SELECT revision FROM configs WHERE id = ##id_configs::gint))",
+	[STMT_KEYS_DELETE_ALL] = "DELETE FROM \"values\" WHERE id_configs = ##id_configs::gint",
+	/* never below the keys already there, e.g. written by older versions */
+	[STMT_CONFIG_RESERVE_IDS] = "UPDATE configs SET next_id = (CASE"
+	                            " WHEN next_id > (SELECT COALESCE(MAX(id), 0) FROM \"values\" WHERE id_configs = ##id_configs::gint)"
+	                            " THEN next_id"
+	                            " ELSE (SELECT COALESCE(MAX(id), 0) + 1 FROM \"values\" WHERE id_configs = ##id_configs::gint)"
+	                            " END) + ##n::gint"
+	                            " WHERE id = ##id_configs::gint",
+	[STMT_CONFIG_NEXT_ID] = "SELECT next_id FROM configs WHERE id = ##id_configs::gint",
+	[STMT_CONFIG_REVISION] = "SELECT revision FROM configs WHERE id = ##id_configs::gint",
+	[STMT_CONFIG_BUMP_REVISION] = "UPDATE configs SET revision = revision + 1"
+	                              " WHERE id = ##id_configs::gint",
+	[STMT_KEYS_CHANGED] = "SELECT id, id_parent, \"key\", value FROM \"values\""
+	                      " WHERE id_configs = ##id_configs::gint"
+	                      " AND revision > ##revision::gint64",
+	[STMT_KEY_REMOVED] = "INSERT INTO values_removed (id_configs, path, revision)"
+	                     " VALUES (##id_configs::gint, ##path::string,"
+	                     " (SELECT revision FROM configs WHERE id = ##id_configs::gint))",
+	[STMT_KEYS_REMOVED_SINCE] = "SELECT path FROM values_removed"
+	                            " WHERE id_configs = ##id_configs::gint"
+	                            " AND revision > ##revision::gint64",
+	[STMT_KEYS_REMOVED_DELETE_ALL] = "DELETE FROM values_removed WHERE id_configs = ##id_configs::gint",
+	/* only with WITH RECURSIVE */
+	[STMT_KEYS_BRANCH] = "WITH RECURSIVE branch (id, lvl) AS ("
+	                     "SELECT id, 1 FROM \"values\""
+	                     " WHERE id_configs = ##id_configs::gint"
+	                     " AND id_parent = ##id_parent::gint"
+	                     " UNION ALL"
+	                     " SELECT v.id, b.lvl + 1 FROM \"values\" v, branch b"
+	                     " WHERE v.id_configs = ##id_configs::gint"
+	                     " AND v.id_parent = b.id"
+	                     " AND b.lvl < ##max_depth::gint)"
+	                     " SELECT v.* FROM \"values\" v, branch b"
+	                     " WHERE v.id_configs = ##id_configs::gint"
+	                     " AND v.id = b.id"
+	                     " ORDER BY v.id",
+	/* SQLite compares text as bytes; PostgreSQL by the locale, unless
+	 * told otherwise */
+	[STMT_KEYS_PATHS] = ZAK_CONFI_DB_PLUGIN_SQL_KEYS_PATHS,
+	[STMT_KEYS_PATHS_C] = ZAK_CONFI_DB_PLUGIN_SQL_KEYS_PATHS " COLLATE \"C\"",
+	[STMT_KEY_VALUE_BY_ID] = "SELECT value FROM \"values\""
+	                         " WHERE id_configs = ##id_configs::gint"
+	                         " AND id = ##id::gint",
+	/* only with WITH RECURSIVE; UNION stops on cycles */
+	[STMT_KEYS_DELETE_BRANCH] = "DELETE FROM \"values\""
+	                            " WHERE id_configs = ##id_configs::gint"
+	                            " AND id IN (WITH RECURSIVE branch (id) AS ("
+	                            "SELECT id FROM \"values\""
+	                            " WHERE id_configs = ##id_configs::gint"
+	                            " AND id = ##id::gint"
+	                            " UNION"
+	                            " SELECT v.id FROM \"values\" v, branch b"
+	                            " WHERE v.id_configs = ##id_configs::gint"
+	                            " AND v.id_parent = b.id)"
+	                            " SELECT id FROM branch)",
+	/* only with WITH RECURSIVE; the descendants of a renamed key */
+	[STMT_KEYS_TOUCH_BRANCH] = "UPDATE \"values\""
+	                           " SET revision = (SELECT revision FROM configs WHERE id = ##id_configs::gint)"
+	                           " WHERE id_configs = ##id_configs::gint"
+	                           " AND id IN (WITH RECURSIVE branch (id) AS ("
+	                           "SELECT id FROM \"values\""
+	                           " WHERE id_configs = ##id_configs::gint"
+	                           " AND id = ##id::gint"
+	                           " UNION"
+	                           " SELECT v.id FROM \"values\" v, branch b"
+	                           " WHERE v.id_configs = ##id_configs::gint"
+	                           " AND v.id_parent = b.id)"
+	                           " SELECT id FROM branch)",
+	[STMT_KEY_BY_ID] = "SELECT id, id_parent, \"key\" FROM \"values\""
+	                   " WHERE id_configs = ##id_configs::gint"
+	                   " AND id = ##id::gint",
+	[STMT_KEYS_REMOVED_PRUNE] = "DELETE FROM values_removed"
+	                            " WHERE id_configs = ##id_configs::gint"
+	                            " AND revision <= ##revision::gint64"
+};
+
+/* the most ids in one IN (...) list */
+#define ZAK_CONFI_DB_PLUGIN_IDS_BATCH 500
+
+/* the most keys in one IN (...) list of paths_get_values */
+#define ZAK_CONFI_DB_PLUGIN_KEYS_BATCH 256
+
+/* the new key ids reserved at once in configs.next_id */
+#define ZAK_CONFI_DB_PLUGIN_IDS_BLOCK 100
+
+/* the revisions for which the removed paths are kept in values_removed;
+ * the changes since an older revision aren't known anymore */
+#define ZAK_CONFI_DB_PLUGIN_REMOVED_KEEP 10000
+
+typedef struct
+	{
+		GdaStatement *stmt;
+		GdaSet *params;
+	} ZakConfiDBPrepared;
+
+/* process-wide pool of connections, keyed by the connection string
+ * without CONFI_NAME: the instances of different configurations in the
+ * same database share up to max connections; while an instance has a
+ * transaction open, the others sharing its connection wait for its end
+ * before running their statements */
+struct _ZakConfiDBConnection
+	{
+		GdaEx *gdaex;
+		guint users;
+
+		/* lock guards owner, the instance with the transaction, and
+		 * active, the number of statements running */
+		GMutex lock;
+		GCond cond;
+		gpointer owner;
+		guint active;
+	};
+
+typedef struct
+	{
+		GPtrArray *cncs;
+		guint max;
+	} ZakConfiDBPool;
+
+#define ZAK_CONFI_DB_POOL_DEFAULT_SIZE 1
+
+static GMutex pool_mutex;
+static GHashTable *pools = NULL;
+
 typedef struct _ZakConfiDBPluginPrivate ZakConfiDBPluginPrivate;
 struct _ZakConfiDBPluginPrivate
 	{
 		gchar *cnc_string;
 
+		/* from the pool; gdaex is its connection */
+		ZakConfiDBConnection *cnc;
 		GdaEx *gdaex;
 
 		gint id_config;
@@ -58,7 +279,32 @@ struct _ZakConfiDBPluginPrivate
 		gchar *description;
 		gchar *root;
 
+		/* the id of the root's key, the start of the relative lookups;
+		 * -1 until resolved, 0 if the root is "/" or doesn't exist */
+		gint root_id;
+
 		gchar chrquot;
+		gboolean recursive_cte;
+		gboolean collate_c;
+
+		/* the trees share also the equal values */
+		gboolean intern_values;
+
+		/* the key ids reserved and not used yet, ids_next..ids_end - 1;
+		 * dropped when the transaction that reserved them is undone */
+		gint ids_next;
+		gint ids_end;
+
+		/* TRUE between begin and commit/rollback; otherwise every write
+		 * is wrapped in its own transaction, with the revision bump */
+		gboolean transaction;
+		gboolean write_transaction;
+
+		GdaSqlParser *parser;
+		ZakConfiDBPrepared stmts[STMT_N];
+		GPtrArray *path_stmts;
+		GPtrArray *probe_stmts;
+		GPtrArray *in_stmts;
 	};
 
 G_DEFINE_DYNAMIC_TYPE_EXTENDED (ZakConfiDBPlugin,
@@ -73,7 +319,8 @@ enum {
 	PROP_CNC_STRING,
 	PROP_NAME,
 	PROP_DESCRIPTION,
-	PROP_ROOT
+	PROP_ROOT,
+	PROP_INTERN_VALUES
 };
 
 static void
@@ -82,7 +329,8 @@ zak_confi_db_plugin_set_property (GObject      *object,
                               const GValue *value,
                               GParamSpec   *pspec)
 {
-	gchar *sql;
+	GdaStatement *stmt;
+	GdaSet *params;
 
 	ZakConfiDBPlugin *plugin = ZAK_CONFI_DB_PLUGIN (object);
 	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (plugin);
@@ -95,28 +343,32 @@ zak_confi_db_plugin_set_property (GObject      *object,
 
 			case PROP_NAME:
 				priv->name = g_strdup (g_value_get_string (value));
-				sql = g_strdup_printf ("UPDATE configs "
-				                       "SET name = '%s' "
-				                       "WHERE id = %d",
-				                       gdaex_strescape (priv->name, NULL),
-				                       priv->id_config);
-				gdaex_execute (priv->gdaex, sql);
-				g_free (sql);
+				stmt = zak_confi_db_plugin_get_statement ((ZakConfiPluggable *)plugin, STMT_CONFIG_SET_NAME, &params);
+				if (stmt != NULL)
+					{
+						zak_confi_db_plugin_set_param_string (params, "name", priv->name);
+						zak_confi_db_plugin_execute ((ZakConfiPluggable *)plugin, stmt, params);
+					}
 				break;
 
 			case PROP_DESCRIPTION:
 				priv->description = g_strdup (g_value_get_string (value));
-				sql = g_strdup_printf ("UPDATE configs "
-				                       "SET description = '%s' "
-				                       "WHERE id = %d",
-				                       gdaex_strescape (priv->description, NULL),
-				                       priv->id_config);
-				gdaex_execute (priv->gdaex, sql);
-				g_free (sql);
+				stmt = zak_confi_db_plugin_get_statement ((ZakConfiPluggable *)plugin, STMT_CONFIG_SET_DESCRIPTION, &params);
+				if (stmt != NULL)
+					{
+						zak_confi_db_plugin_set_param_string (params, "description", priv->description);
+						zak_confi_db_plugin_execute ((ZakConfiPluggable *)plugin, stmt, params);
+					}
 				break;
 
 			case PROP_ROOT:
+				g_free (priv->root);
 				priv->root = zak_confi_normalize_root (g_value_get_string (value));
+				priv->root_id = -1;
+				break;
+
+			case PROP_INTERN_VALUES:
+				priv->intern_values = g_value_get_boolean (value);
 				break;
 
 			default:
@@ -152,6 +404,10 @@ zak_confi_db_plugin_get_property (GObject    *object,
 				g_value_set_string (value, priv->root);
 				break;
 
+			case PROP_INTERN_VALUES:
+				g_value_set_boolean (value, priv->intern_values);
+				break;
+
 			default:
 				G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 				break;
@@ -164,15 +420,84 @@ zak_confi_db_plugin_init (ZakConfiDBPlugin *plugin)
 	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (plugin);
 
 	priv->cnc_string = NULL;
+	priv->cnc = NULL;
 	priv->gdaex = NULL;
 	priv->name = NULL;
 	priv->description = NULL;
+
+	priv->root_id = -1;
+	priv->intern_values = FALSE;
+	priv->ids_next = 0;
+	priv->ids_end = 0;
+
+	priv->transaction = FALSE;
+	priv->write_transaction = FALSE;
+
+	priv->parser = NULL;
+	memset (priv->stmts, 0, sizeof (priv->stmts));
+	priv->path_stmts = g_ptr_array_new_with_free_func (zak_confi_db_plugin_prepared_destroy);
+	priv->probe_stmts = g_ptr_array_new_with_free_func (zak_confi_db_plugin_prepared_destroy);
+	priv->in_stmts = g_ptr_array_new_with_free_func (zak_confi_db_plugin_prepared_destroy);
+}
+
+static void
+zak_confi_db_plugin_prepared_free (ZakConfiDBPrepared *prepared)
+{
+	if (prepared->stmt != NULL)
+		{
+			g_object_unref (prepared->stmt);
+			prepared->stmt = NULL;
+		}
+	if (prepared->params != NULL)
+		{
+			g_object_unref (prepared->params);
+			prepared->params = NULL;
+		}
+}
+
+/* for the arrays of statements prepared on demand */
+static void
+zak_confi_db_plugin_prepared_destroy (gpointer data)
+{
+	ZakConfiDBPrepared *prepared = (ZakConfiDBPrepared *)data;
+
+	if (prepared != NULL)
+		{
+			zak_confi_db_plugin_prepared_free (prepared);
+			g_slice_free (ZakConfiDBPrepared, prepared);
+		}
 }
 
 static void
 zak_confi_db_plugin_finalize (GObject *object)
 {
+	guint i;
+
 	ZakConfiDBPlugin *plugin = ZAK_CONFI_DB_PLUGIN (object);
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (plugin);
+
+	for (i = 0; i < STMT_N; i++)
+		{
+			zak_confi_db_plugin_prepared_free (&priv->stmts[i]);
+		}
+	g_ptr_array_free (priv->path_stmts, TRUE);
+	g_ptr_array_free (priv->probe_stmts, TRUE);
+	g_ptr_array_free (priv->in_stmts, TRUE);
+	if (priv->parser != NULL)
+		{
+			g_object_unref (priv->parser);
+		}
+	if (priv->cnc != NULL)
+		{
+			/* the others sharing the connection aren't held anymore */
+			if (priv->transaction)
+				{
+					zak_confi_db_plugin_transaction_end ((ZakConfiPluggable *)object, FALSE);
+				}
+			zak_confi_db_plugin_pool_release (priv->cnc_string, priv->cnc);
+		}
+	g_free (priv->cnc_string);
+	g_free (priv->root);
 
 	G_OBJECT_CLASS (zak_confi_db_plugin_parent_class)->finalize (object);
 }
@@ -188,10 +513,14 @@ zak_confi_db_plugin_initialize (ZakConfiPluggable *pluggable, const gchar *cnc_s
 	guint i;
 	guint l;
 
-	gchar *sql;
+	GdaStatement *stmt;
+	GdaSet *params;
 	GdaDataModel *dm;
 
 	gchar *cnc_string_;
+	guint pool_size;
+
+	pool_size = 0;
 
 	cnc_string_ = g_strdup_printf ("%s;", cnc_string);
 	strs = g_strsplit (cnc_string_, ";", -1);
@@ -210,12 +539,24 @@ zak_confi_db_plugin_initialize (ZakConfiPluggable *pluggable, const gchar *cnc_s
 							priv->name[strlen (priv->name)] = '\0';
 						}
 				}
+			else if (g_str_has_prefix (strs[i], "POOL_SIZE="))
+				{
+					/* maximum number of connections shared with the other
+					 * configurations in the same database */
+					pool_size = (guint)g_ascii_strtoull (strs[i] + strlen ("POOL_SIZE="), NULL, 10);
+				}
 			else
 				{
 					g_string_append (gstr_cnc_string, strs[i]);
 					g_string_append (gstr_cnc_string, ";");
 				}
 		}
+	if (priv->cnc != NULL)
+		{
+			zak_confi_db_plugin_pool_release (priv->cnc_string, priv->cnc);
+			priv->cnc = NULL;
+			priv->gdaex = NULL;
+		}
 	if (priv->cnc_string != NULL)
 		{
 			g_free (priv->cnc_string);
@@ -230,17 +571,26 @@ zak_confi_db_plugin_initialize (ZakConfiPluggable *pluggable, const gchar *cnc_s
 			priv->name = g_strdup ("Default");
 		}
 
-	priv->gdaex = gdaex_new_from_string (priv->cnc_string);
+	priv->cnc = zak_confi_db_plugin_pool_acquire (priv->cnc_string, pool_size);
+	if (priv->cnc == NULL)
+		{
+			return FALSE;
+		}
+	priv->gdaex = priv->cnc->gdaex;
 	priv->chrquot = gdaex_get_chr_quoting (priv->gdaex);
+	priv->recursive_cte = zak_confi_db_plugin_provider_has_recursive_cte (gdaex_get_provider (priv->gdaex));
+	priv->collate_c = (gdaex_get_provider (priv->gdaex) != NULL
+	                   && g_ascii_strcasecmp (gdaex_get_provider (priv->gdaex), "PostgreSQL") == 0);
 
 	/* check if config exists */
-	sql = g_strdup_printf ("SELECT id, name"
-	                       " FROM configs"
-	                       " WHERE name = '%s'",
-	                       gdaex_strescape (priv->name, NULL));
-	dm = gdaex_query (priv->gdaex, sql);
-	g_free (sql);
-	if (dm != NULL || gda_data_model_get_n_rows (dm) > 0)
+	dm = NULL;
+	stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_CONFIG_BY_NAME, &params);
+	if (stmt != NULL)
+		{
+			zak_confi_db_plugin_set_param_string (params, "name", priv->name);
+			dm = zak_confi_db_plugin_select (pluggable, stmt, params);
+		}
+	if (dm != NULL && gda_data_model_get_n_rows (dm) > 0)
 		{
 			priv->id_config = gdaex_data_model_get_value_integer_at (dm, 0, 0);
 		}
@@ -252,280 +602,1751 @@ zak_confi_db_plugin_initialize (ZakConfiPluggable *pluggable, const gchar *cnc_s
 	return (priv->gdaex != NULL && priv->name != NULL ? TRUE : FALSE);
 }
 
-static GdaDataModel
-*zak_confi_db_plugin_path_get_data_model (ZakConfiPluggable *pluggable, const gchar *path)
+static void
+zak_confi_db_plugin_pool_free (gpointer data)
 {
-	gchar **tokens;
-	gchar *sql;
-	gchar *token;
+	ZakConfiDBPool *pool = (ZakConfiDBPool *)data;
+
+	g_ptr_array_free (pool->cncs, TRUE);
+	g_slice_free (ZakConfiDBPool, pool);
+}
+
+static void
+zak_confi_db_plugin_connection_free (ZakConfiDBConnection *cnc)
+{
+	g_object_unref (cnc->gdaex);
+	g_mutex_clear (&cnc->lock);
+	g_cond_clear (&cnc->cond);
+	g_slice_free (ZakConfiDBConnection, cnc);
+}
+
+/* returns a connection for @cnc_string: a new one while the pool has
+ * less than @max (0 for the current size) connections, otherwise the
+ * least used one */
+static ZakConfiDBConnection
+*zak_confi_db_plugin_pool_acquire (const gchar *cnc_string, guint max)
+{
+	ZakConfiDBPool *pool;
+	ZakConfiDBConnection *cnc;
+	ZakConfiDBConnection *cnc_;
+	GdaEx *gdaex;
 	guint i;
-	guint id_parent;
-	GdaDataModel *dm;
 
-	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+	g_mutex_lock (&pool_mutex);
 
-	if (path == NULL) return NULL;
+	if (pools == NULL)
+		{
+			pools = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, zak_confi_db_plugin_pool_free);
+		}
 
-	dm = NULL;
+	pool = (ZakConfiDBPool *)g_hash_table_lookup (pools, cnc_string);
+	if (pool == NULL)
+		{
+			pool = g_slice_new (ZakConfiDBPool);
+			pool->cncs = g_ptr_array_new ();
+			pool->max = ZAK_CONFI_DB_POOL_DEFAULT_SIZE;
+			g_hash_table_insert (pools, g_strdup (cnc_string), pool);
+		}
+	if (max > 0)
+		{
+			pool->max = max;
+		}
 
-	tokens = g_strsplit (path, "/", 0);
-	if (tokens == NULL) return NULL;
+	cnc = NULL;
+	if (pool->cncs->len >= pool->max)
+		{
+			for (i = 0; i < pool->cncs->len; i++)
+				{
+					cnc_ = (ZakConfiDBConnection *)g_ptr_array_index (pool->cncs, i);
+					if (cnc == NULL || cnc_->users < cnc->users)
+						{
+							cnc = cnc_;
+						}
+				}
+		}
+	if (cnc == NULL)
+		{
+			gdaex = gdaex_new_from_string (cnc_string);
+			if (gdaex != NULL)
+				{
+					cnc = g_slice_new0 (ZakConfiDBConnection);
+					cnc->gdaex = gdaex;
+					g_mutex_init (&cnc->lock);
+					g_cond_init (&cnc->cond);
+					g_ptr_array_add (pool->cncs, cnc);
+				}
+		}
 
-	i = 0;
-	id_parent = 0;
-	while (tokens[i] != NULL)
+	if (cnc != NULL)
 		{
-			token = g_strstrip (g_strdup (tokens[i]));
-			if (strcmp (token, "") != 0)
+			cnc->users++;
+		}
+	else if (pool->cncs->len == 0)
+		{
+			g_hash_table_remove (pools, cnc_string);
+		}
+
+	g_mutex_unlock (&pool_mutex);
+
+	return cnc;
+}
+
+/* the connection is closed when its last user releases it */
+static void
+zak_confi_db_plugin_pool_release (const gchar *cnc_string, ZakConfiDBConnection *cnc)
+{
+	ZakConfiDBPool *pool;
+	guint i;
+
+	g_mutex_lock (&pool_mutex);
+
+	pool = (pools != NULL ? (ZakConfiDBPool *)g_hash_table_lookup (pools, cnc_string) : NULL);
+	if (pool != NULL)
+		{
+			for (i = 0; i < pool->cncs->len; i++)
 				{
-					sql = g_strdup_printf ("SELECT * "
-					                       "FROM %cvalues%c "
-					                       "WHERE id_configs = %d "
-					                       "AND id_parent = %d "
-					                       "AND %ckey%c = '%s'",
-					                       priv->chrquot, priv->chrquot,
-					                       priv->id_config,
-					                       id_parent,
-					                       priv->chrquot, priv->chrquot,
-					                       gdaex_strescape (token, NULL));
-					dm = gdaex_query (priv->gdaex, sql);
-					g_free (sql);
-					if (dm == NULL || gda_data_model_get_n_rows (dm) != 1)
+					if (g_ptr_array_index (pool->cncs, i) == cnc)
 						{
-							/* TO DO */
-							g_warning ("Unable to find key «%s».", token);
-							if (dm != NULL)
+							if (--cnc->users == 0)
 								{
-									g_object_unref (dm);
-									dm = NULL;
+									zak_confi_db_plugin_connection_free (cnc);
+									g_ptr_array_remove_index_fast (pool->cncs, i);
 								}
 							break;
 						}
-					id_parent = gdaex_data_model_get_field_value_integer_at (dm, 0, "id");
 				}
-
-			i++;
+			if (pool->cncs->len == 0)
+				{
+					g_hash_table_remove (pools, cnc_string);
+				}
 		}
 
-	return dm;
+	g_mutex_unlock (&pool_mutex);
 }
 
-static gchar
-*zak_confi_db_plugin_path_get_value_from_db (ZakConfiPluggable *pluggable, const gchar *path)
+/* a statement of @pluggable starts: it waits while another instance has
+ * a transaction open on the same connection */
+static void
+zak_confi_db_plugin_connection_enter (ZakConfiPluggable *pluggable)
 {
-	gchar *ret;
-	GdaDataModel *dm;
-
-	ret = NULL;
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+	ZakConfiDBConnection *cnc = priv->cnc;
 
-	dm = zak_confi_db_plugin_path_get_data_model (pluggable, path);
-	if (dm != NULL)
+	g_mutex_lock (&cnc->lock);
+	while (cnc->owner != NULL && cnc->owner != pluggable)
 		{
-			ret = gdaex_data_model_get_field_value_stringify_at (dm, 0, "value");
-			g_object_unref (dm);
+			g_cond_wait (&cnc->cond, &cnc->lock);
 		}
-
-	return ret;
+	cnc->active++;
+	g_mutex_unlock (&cnc->lock);
 }
 
 static void
-zak_confi_db_plugin_get_children (ZakConfiPluggable *pluggable, GNode *parentNode, gint idParent, gchar *path)
+zak_confi_db_plugin_connection_leave (ZakConfiPluggable *pluggable)
 {
-	gchar *sql;
-	GdaDataModel *dm;
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+	ZakConfiDBConnection *cnc = priv->cnc;
+
+	g_mutex_lock (&cnc->lock);
+	if (--cnc->active == 0)
+		{
+			g_cond_broadcast (&cnc->cond);
+		}
+	g_mutex_unlock (&cnc->lock);
+}
 
+/* opens a transaction, with the connection held by @pluggable until
+ * its end: no new connection is opened, so the pool's size holds; a
+ * thread holding a transaction must not use another instance sharing
+ * the connection */
+static gboolean
+zak_confi_db_plugin_transaction_begin (ZakConfiPluggable *pluggable)
+{
 	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+	ZakConfiDBConnection *cnc = priv->cnc;
 
-	sql = g_strdup_printf ("SELECT *"
-	                       " FROM %cvalues%c"
-	                       " WHERE id_configs = %d"
-	                       " AND id_parent = %d",
-	                       priv->chrquot, priv->chrquot,
-	                       priv->id_config,
-	                       idParent);
+	if (cnc == NULL)
+		{
+			return FALSE;
+		}
 
-	dm = gdaex_query (priv->gdaex, sql);
-	g_free (sql);
-	if (dm != NULL)
+	/* the statements of the others already running end outside of it */
+	g_mutex_lock (&cnc->lock);
+	while (cnc->owner != NULL || cnc->active > 0)
 		{
-			guint i;
-			guint rows;
+			g_cond_wait (&cnc->cond, &cnc->lock);
+		}
+	cnc->owner = pluggable;
+	g_mutex_unlock (&cnc->lock);
 
-			rows = gda_data_model_get_n_rows (dm);
-			for (i = 0; i < rows; i++)
-				{
-					GNode *newNode;
-					ZakConfiKey *ck = g_new0 (ZakConfiKey, 1);
+	if (!gdaex_begin (priv->gdaex))
+		{
+			g_mutex_lock (&cnc->lock);
+			cnc->owner = NULL;
+			g_cond_broadcast (&cnc->cond);
+			g_mutex_unlock (&cnc->lock);
+			return FALSE;
+		}
 
-					ck->id_config = priv->id_config;
-					ck->id = gdaex_data_model_get_field_value_integer_at (dm, i, "id");
-					ck->id_parent = gdaex_data_model_get_field_value_integer_at (dm, i, "id_parent");
-					ck->key = g_strdup (gdaex_data_model_get_field_value_stringify_at (dm, i, "key"));
-					ck->value = g_strdup (gdaex_data_model_get_field_value_stringify_at (dm, i, "value"));
-					ck->description = g_strdup (gdaex_data_model_get_field_value_stringify_at (dm, i, "description"));
-					ck->path = g_strdup (path);
+	return TRUE;
+}
 
-					newNode = g_node_append_data (parentNode, ck);
+/* commits (if @commit) or rolls back the transaction and hands the
+ * connection back to the others; the reserved ids don't survive a
+ * failed commit */
+static gboolean
+zak_confi_db_plugin_transaction_end (ZakConfiPluggable *pluggable, gboolean commit)
+{
+	gboolean ret;
 
-					zak_confi_db_plugin_get_children (pluggable, newNode, ck->id, g_strconcat (path, (g_strcmp0 (path, "") == 0 ? "" : "/"), ck->key, NULL));
-				}
-			g_object_unref (dm);
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+	ZakConfiDBConnection *cnc = priv->cnc;
+
+	if (commit)
+		{
+			ret = gdaex_commit (priv->gdaex);
+		}
+	else
+		{
+			ret = gdaex_rollback (priv->gdaex);
+		}
+	if (!commit || !ret)
+		{
+			priv->ids_next = 0;
+			priv->ids_end = 0;
 		}
+
+	g_mutex_lock (&cnc->lock);
+	cnc->owner = NULL;
+	g_cond_broadcast (&cnc->cond);
+	g_mutex_unlock (&cnc->lock);
+
+	return ret;
 }
 
-static GList
-*zak_confi_db_plugin_get_configs_list (ZakConfiPluggable *pluggable,
-                                   const gchar *filter)
+static gboolean
+zak_confi_db_plugin_provider_has_recursive_cte (const gchar *provider)
 {
-	GList *lst;
-
-	GdaDataModel *dmZakConfigs;
+	if (provider == NULL)
+		{
+			return FALSE;
+		}
 
-	gchar *sql;
-	gchar *where;
+	return (g_ascii_strcasecmp (provider, "PostgreSQL") == 0
+	        || g_ascii_strcasecmp (provider, "SQLite") == 0);
+}
 
-	guint row;
-	guint id;
-	guint rows;
+static GdaStatement
+*zak_confi_db_plugin_prepare (ZakConfiPluggable *pluggable, const gchar *sql, GdaSet **params)
+{
+	GdaStatement *stmt;
+	gchar *sql_;
+	GError *error;
 
 	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
 
-	lst = NULL;
-
 	if (priv->gdaex == NULL)
 		{
 			return NULL;
 		}
 
-	if (filter != NULL && strcmp (g_strstrip (g_strdup (filter)), "") != 0)
-		{
-			where = g_strdup_printf (" WHERE name LIKE '%s'", filter);
-		}
-	else
+	if (priv->parser == NULL)
 		{
-			where = g_strdup ("");
+			priv->parser = gda_connection_create_parser (gdaex_get_gdaconnection (priv->gdaex));
+			if (priv->parser == NULL)
+				{
+					priv->parser = gda_sql_parser_new ();
+				}
 		}
 
-	sql = g_strdup_printf ("SELECT * FROM configs%s", where);
-	g_free (where);
+	sql_ = g_strdelimit (g_strdup (sql), "\"", priv->chrquot);
 
-	dmZakConfigs = gdaex_query (priv->gdaex, sql);
-	g_free (sql);
-	if (dmZakConfigs != NULL)
+	error = NULL;
+	stmt = gda_sql_parser_parse_string (priv->parser, sql_, NULL, &error);
+	if (stmt == NULL || error != NULL)
 		{
-			rows = gda_data_model_get_n_rows (dmZakConfigs);
-			if (rows > 0)
+			g_warning ("Unable to parse statement «%s»: %s.",
+			           sql_,
+			           error != NULL && error->message != NULL ? error->message : "no details");
+			if (stmt != NULL)
 				{
-					for (row = 0; row < rows; row++)
-						{
-							ZakConfiConfi *confi;
-							confi = g_new0 (ZakConfiConfi, 1);
-							confi->name = gdaex_data_model_get_field_value_stringify_at (dmZakConfigs, row, "name");
-							confi->description = gdaex_data_model_get_field_value_stringify_at (dmZakConfigs, row, "description");
-							lst = g_list_append (lst, confi);
-						}
+					g_object_unref (stmt);
+					stmt = NULL;
 				}
-			else
+		}
+	else
+		{
+			*params = NULL;
+			if (!gda_statement_get_parameters (stmt, params, &error))
 				{
-					lst = g_list_append (lst, NULL);
+					g_warning ("Unable to get the parameters of statement «%s»: %s.",
+					           sql_,
+					           error != NULL && error->message != NULL ? error->message : "no details");
+					g_object_unref (stmt);
+					stmt = NULL;
 				}
 		}
+	g_free (sql_);
+	if (error != NULL)
+		{
+			g_error_free (error);
+		}
 
-	return lst;
+	return stmt;
 }
 
-static gchar
-*zak_confi_db_plugin_path_get_value (ZakConfiPluggable *pluggable, const gchar *path)
+/* returns the statement @stmt of the fixed set, preparing it at its first use */
+static GdaStatement
+*zak_confi_db_plugin_get_statement (ZakConfiPluggable *pluggable, guint stmt, GdaSet **params)
 {
-	gchar *ret;
-	gchar *path_;
+	ZakConfiDBPrepared *prepared;
 
 	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
 
-	ret = NULL;
-
-	path_ = zak_confi_path_normalize (pluggable, path);
-	if (path_ == NULL)
+	prepared = &priv->stmts[stmt];
+	if (prepared->stmt == NULL)
 		{
-			return NULL;
+			prepared->stmt = zak_confi_db_plugin_prepare (pluggable, zak_confi_db_plugin_sql[stmt], &prepared->params);
 		}
 
-	ret = zak_confi_db_plugin_path_get_value_from_db (pluggable, path_);
-
-	return ret;
+	*params = prepared->params;
+	return prepared->stmt;
 }
 
-static gboolean
-zak_confi_db_plugin_path_set_value (ZakConfiPluggable *pluggable, const gchar *path, const gchar *value)
+static void
+zak_confi_db_plugin_set_param_string (GdaSet *params, const gchar *name, const gchar *value)
 {
-	GdaDataModel *dm;
-	gchar *sql;
-	gboolean ret;
+	GdaHolder *holder;
+	GValue gval = {0};
 
-	dm = zak_confi_db_plugin_path_get_data_model (pluggable, zak_confi_path_normalize (pluggable, path));
-
-	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
-
-	ret = FALSE;
-	if (dm != NULL && gda_data_model_get_n_rows (dm) > 0)
+	holder = gda_set_get_holder (params, name);
+	if (holder == NULL)
 		{
-			sql = g_strdup_printf ("UPDATE %cvalues%c"
-			                       " SET value = '%s'"
-			                       " WHERE id_configs = %d"
-			                       " AND id = %d",
-			                       priv->chrquot, priv->chrquot,
-			                       gdaex_strescape (value, NULL),
-			                       priv->id_config,
-			                       gdaex_data_model_get_field_value_integer_at (dm, 0, "id"));
-			ret = (gdaex_execute (priv->gdaex, sql) >= 0);
-			g_free (sql);
+			return;
 		}
-	else
+
+	if (value == NULL)
 		{
-			g_warning ("Path %s doesn't exists.", path);
+			gda_holder_set_value (holder, NULL, NULL);
 		}
-	if (dm != NULL)
+	else
 		{
-			g_object_unref (dm);
+			g_value_init (&gval, G_TYPE_STRING);
+			g_value_set_string (&gval, value);
+			gda_holder_set_value (holder, &gval, NULL);
+			g_value_unset (&gval);
 		}
-
-	return ret;
 }
 
-GNode
-*zak_confi_db_plugin_get_tree (ZakConfiPluggable *pluggable)
+static GdaDataModel
+*zak_confi_db_plugin_select (ZakConfiPluggable *pluggable, GdaStatement *stmt, GdaSet *params)
 {
-	gchar *path;
-	GNode *node;
+	GdaDataModel *dm;
+	GError *error;
 
 	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
 
-	path = g_strdup ("");
-
-	ZakConfiKey *ck = g_new0 (ZakConfiKey, 1);
-
-	ck->id_config = priv->id_config;
-	ck->id = 0;
-	ck->id_parent = 0;
-	ck->path = "";
-	ck->description = "";
-	ck->key = g_strdup ("/");
-	ck->value = "";
-
-	node = g_node_new (ck);
-
-	zak_confi_db_plugin_get_children (pluggable, node, 0, path);
+	if (params != NULL && gda_set_get_holder (params, "id_configs") != NULL)
+		{
+			gda_set_set_holder_value (params, NULL, "id_configs", priv->id_config);
+		}
+
+	error = NULL;
+	zak_confi_db_plugin_connection_enter (pluggable);
+	dm = gda_connection_statement_execute_select (gdaex_get_gdaconnection (priv->gdaex), stmt, params, &error);
+	zak_confi_db_plugin_connection_leave (pluggable);
+	if (dm == NULL || error != NULL)
+		{
+			g_warning ("Error on executing the query: %s.",
+			           error != NULL && error->message != NULL ? error->message : "no details");
+			if (dm != NULL)
+				{
+					g_object_unref (dm);
+					dm = NULL;
+				}
+			if (error != NULL)
+				{
+					g_error_free (error);
+				}
+		}
+
+	return dm;
+}
+
+static gint
+zak_confi_db_plugin_execute (ZakConfiPluggable *pluggable, GdaStatement *stmt, GdaSet *params)
+{
+	gint ret;
+	GError *error;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (params != NULL && gda_set_get_holder (params, "id_configs") != NULL)
+		{
+			gda_set_set_holder_value (params, NULL, "id_configs", priv->id_config);
+		}
+
+	error = NULL;
+	zak_confi_db_plugin_connection_enter (pluggable);
+	ret = gda_connection_statement_execute_non_select (gdaex_get_gdaconnection (priv->gdaex), stmt, params, NULL, &error);
+	zak_confi_db_plugin_connection_leave (pluggable);
+	if (error != NULL)
+		{
+			g_warning ("Error on executing the statement: %s.",
+			           error->message != NULL ? error->message : "no details");
+			g_error_free (error);
+			ret = -1;
+		}
+
+	return ret;
+}
+
+/* returns the statement that resolves a path of @depth segments, starting
+ * from ##id_parent, in only one round trip: a recursive walk where the
+ * provider supports WITH RECURSIVE, otherwise a chain of self-joins;
+ * with @probe it returns instead the number of segments matched (lvl),
+ * deepest first, and the value of the deepest key matched */
+static GdaStatement
+*zak_confi_db_plugin_get_path_statement (ZakConfiPluggable *pluggable, guint depth, gboolean probe, GdaSet **params)
+{
+	ZakConfiDBPrepared *prepared;
+	GPtrArray *stmts;
+	GString *sql;
+	guint i;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	stmts = (probe ? priv->probe_stmts : priv->path_stmts);
+	if (stmts->len < depth)
+		{
+			g_ptr_array_set_size (stmts, depth);
+		}
+
+	prepared = (ZakConfiDBPrepared *)g_ptr_array_index (stmts, depth - 1);
+	if (prepared != NULL)
+		{
+			*params = prepared->params;
+			return prepared->stmt;
+		}
+
+	sql = g_string_new ("");
+	if (priv->recursive_cte && depth > 1)
+		{
+			g_string_append (sql,
+			                 "WITH RECURSIVE walk (id, lvl) AS ("
+			                 "SELECT id, 1 FROM \"values\""
+			                 " WHERE id_configs = ##id_configs::gint"
+			                 " AND id_parent = ##id_parent::gint"
+			                 " AND \"key\" = ##k1::string"
+			                 " UNION ALL"
+			                 " SELECT v.id, w.lvl + 1 FROM \"values\" v, walk w"
+			                 " WHERE v.id_configs = ##id_configs::gint"
+			                 " AND v.id_parent = w.id");
+			g_string_append_printf (sql, " AND w.lvl < %u AND v.\"key\" = CASE w.lvl", depth);
+			for (i = 1; i < depth; i++)
+				{
+					g_string_append_printf (sql, " WHEN %u THEN ##k%u::string", i, i + 1);
+				}
+			if (probe)
+				{
+					g_string_append (sql,
+					                 " END)"
+					                 " SELECT w.lvl, v.\"value\" FROM \"values\" v, walk w"
+					                 " WHERE v.id_configs = ##id_configs::gint"
+					                 " AND v.id = w.id"
+					                 " ORDER BY w.lvl DESC");
+				}
+			else
+				{
+					g_string_append_printf (sql,
+					                        " END)"
+					                        " SELECT v.* FROM \"values\" v, walk w"
+					                        " WHERE v.id_configs = ##id_configs::gint"
+					                        " AND v.id = w.id"
+					                        " AND w.lvl = %u",
+					                        depth);
+				}
+		}
+	else if (probe)
+		{
+			/* the missing levels are NULL */
+			g_string_append (sql, "SELECT CASE");
+			for (i = depth; i > 1; i--)
+				{
+					g_string_append_printf (sql, " WHEN v%u.id IS NOT NULL THEN %u", i, i);
+				}
+			g_string_append_printf (sql, " ELSE 1 END AS lvl, v%u.\"value\" FROM \"values\" v1", depth);
+			for (i = 2; i <= depth; i++)
+				{
+					g_string_append_printf (sql,
+					                        " LEFT JOIN \"values\" v%u ON v%u.id_configs = ##id_configs::gint"
+					                        " AND v%u.id_parent = v%u.id"
+					                        " AND v%u.\"key\" = ##k%u::string",
+					                        i, i, i, i - 1, i, i);
+				}
+			g_string_append (sql,
+			                 " WHERE v1.id_configs = ##id_configs::gint"
+			                 " AND v1.id_parent = ##id_parent::gint"
+			                 " AND v1.\"key\" = ##k1::string");
+		}
+	else
+		{
+			g_string_append_printf (sql, "SELECT v%u.* FROM ", depth);
+			for (i = 1; i <= depth; i++)
+				{
+					g_string_append_printf (sql, "%s\"values\" v%u", (i == 1 ? "" : ", "), i);
+				}
+			for (i = 1; i <= depth; i++)
+				{
+					g_string_append_printf (sql, " %s v%u.id_configs = ##id_configs::gint",
+					                        (i == 1 ? "WHERE" : "AND"),
+					                        i);
+					if (i == 1)
+						{
+							g_string_append (sql, " AND v1.id_parent = ##id_parent::gint");
+						}
+					else
+						{
+							g_string_append_printf (sql, " AND v%u.id_parent = v%u.id", i, i - 1);
+						}
+					g_string_append_printf (sql, " AND v%u.\"key\" = ##k%u::string", i, i);
+				}
+		}
+
+	prepared = g_slice_new0 (ZakConfiDBPrepared);
+	prepared->stmt = zak_confi_db_plugin_prepare (pluggable, sql->str, &prepared->params);
+	g_string_free (sql, TRUE);
+	if (prepared->stmt == NULL)
+		{
+			g_slice_free (ZakConfiDBPrepared, prepared);
+			return NULL;
+		}
+	g_ptr_array_index (stmts, depth - 1) = prepared;
+
+	*params = prepared->params;
+	return prepared->stmt;
+}
+
+/* returns the statement that reads the rows whose key is one of
+ * ##k1..##k@size; there is one for every power of two, @size is the
+ * first one not less than @n and the caller repeats the last key in the
+ * parameters left */
+static GdaStatement
+*zak_confi_db_plugin_get_in_statement (ZakConfiPluggable *pluggable, guint n, guint *size, GdaSet **params)
+{
+	ZakConfiDBPrepared *prepared;
+	GString *sql;
+	guint slot;
+	guint i;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	*size = 1;
+	slot = 0;
+	while (*size < n)
+		{
+			*size <<= 1;
+			slot++;
+		}
+
+	if (priv->in_stmts->len <= slot)
+		{
+			g_ptr_array_set_size (priv->in_stmts, slot + 1);
+		}
+
+	prepared = (ZakConfiDBPrepared *)g_ptr_array_index (priv->in_stmts, slot);
+	if (prepared != NULL)
+		{
+			*params = prepared->params;
+			return prepared->stmt;
+		}
+
+	sql = g_string_new ("SELECT id, id_parent, \"key\", value FROM \"values\""
+	                    " WHERE id_configs = ##id_configs::gint"
+	                    " AND \"key\" IN (");
+	for (i = 1; i <= *size; i++)
+		{
+			g_string_append_printf (sql, "%s##k%u::string", (i == 1 ? "" : ", "), i);
+		}
+	g_string_append (sql, ")");
+
+	prepared = g_slice_new0 (ZakConfiDBPrepared);
+	prepared->stmt = zak_confi_db_plugin_prepare (pluggable, sql->str, &prepared->params);
+	g_string_free (sql, TRUE);
+	if (prepared->stmt == NULL)
+		{
+			g_slice_free (ZakConfiDBPrepared, prepared);
+			return NULL;
+		}
+	g_ptr_array_index (priv->in_stmts, slot) = prepared;
+
+	*params = prepared->params;
+	return prepared->stmt;
+}
+
+/* resolves the root's key once, after every change of root */
+static gint
+zak_confi_db_plugin_get_root_id (ZakConfiPluggable *pluggable)
+{
+	GdaDataModel *dm;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (priv->root_id < 0)
+		{
+			/* the root's path starts from the top */
+			priv->root_id = 0;
+			if (priv->root != NULL && strlen (priv->root) > 1)
+				{
+					dm = zak_confi_db_plugin_path_get_data_model (pluggable, priv->root);
+					if (dm != NULL)
+						{
+							priv->root_id = gdaex_data_model_get_field_value_integer_at (dm, 0, "id");
+							g_object_unref (dm);
+						}
+				}
+		}
+
+	return priv->root_id;
+}
+
+static GdaDataModel
+*zak_confi_db_plugin_path_get_data_model (ZakConfiPluggable *pluggable, const gchar *path)
+{
+	return zak_confi_db_plugin_path_get_data_model_full (pluggable, path, FALSE);
+}
+
+/* with @quiet a missing key isn't logged */
+static GdaDataModel
+*zak_confi_db_plugin_path_get_data_model_full (ZakConfiPluggable *pluggable, const gchar *path, gboolean quiet)
+{
+	return zak_confi_db_plugin_path_query (pluggable, path, FALSE, quiet, NULL, NULL);
+}
+
+/* runs the path statement for @path (the probe one with @probe); @skip
+ * is set to the length of the root's prefix resolved from its key, and
+ * @depth to the number of segments after it */
+static GdaDataModel
+*zak_confi_db_plugin_path_query (ZakConfiPluggable *pluggable, const gchar *path, gboolean probe, gboolean quiet, guint *skip, guint *depth_)
+{
+	gchar **tokens;
+	gchar **segments;
+	gchar *token;
+	gchar param[16];
+	guint i;
+	guint depth;
+	guint len;
+	gint id_parent;
+	GdaStatement *stmt;
+	GdaSet *params;
+	GdaDataModel *dm;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (path == NULL) return NULL;
+
+	dm = NULL;
+
+	/* the paths below the root are resolved starting from its key */
+	id_parent = 0;
+	len = (priv->root != NULL ? strlen (priv->root) : 0);
+	if (len > 1
+	    && strncmp (path, priv->root, len) == 0
+	    && zak_confi_db_plugin_get_root_id (pluggable) > 0)
+		{
+			id_parent = priv->root_id;
+		}
+	else
+		{
+			len = 0;
+		}
+
+	if (skip != NULL)
+		{
+			*skip = len;
+		}
+
+	tokens = g_strsplit (path + len, "/", 0);
+	if (tokens == NULL) return NULL;
+
+	segments = g_new (gchar *, g_strv_length (tokens) + 1);
+	depth = 0;
+	for (i = 0; tokens[i] != NULL; i++)
+		{
+			token = g_strstrip (tokens[i]);
+			if (strcmp (token, "") != 0)
+				{
+					segments[depth++] = token;
+				}
+		}
+
+	if (depth_ != NULL)
+		{
+			*depth_ = depth;
+		}
+
+	if (depth > 0)
+		{
+			stmt = zak_confi_db_plugin_get_path_statement (pluggable, depth, probe, &params);
+			if (stmt != NULL)
+				{
+					gda_set_set_holder_value (params, NULL, "id_parent", id_parent);
+					for (i = 0; i < depth; i++)
+						{
+							g_snprintf (param, sizeof (param), "k%u", i + 1);
+							zak_confi_db_plugin_set_param_string (params, param, segments[i]);
+						}
+					dm = zak_confi_db_plugin_select (pluggable, stmt, params);
+				}
+			if (probe)
+				{
+					if (dm != NULL && gda_data_model_get_n_rows (dm) == 0)
+						{
+							g_object_unref (dm);
+							dm = NULL;
+						}
+				}
+			else if (dm == NULL || gda_data_model_get_n_rows (dm) != 1)
+				{
+					if (!quiet)
+						{
+							g_warning ("Unable to find key «%s».", path);
+						}
+					if (dm != NULL)
+						{
+							g_object_unref (dm);
+							dm = NULL;
+						}
+				}
+		}
+
+	g_free (segments);
+	g_strfreev (tokens);
+
+	return dm;
+}
+
+static gchar
+*zak_confi_db_plugin_path_get_value_from_db (ZakConfiPluggable *pluggable, const gchar *path)
+{
+	gchar *ret;
+	GdaDataModel *dm;
+
+	ret = NULL;
+
+	dm = zak_confi_db_plugin_path_get_data_model (pluggable, path);
+	if (dm != NULL)
+		{
+			ret = gdaex_data_model_get_field_value_stringify_at (dm, 0, "value");
+			g_object_unref (dm);
+		}
+
+	return ret;
+}
+
+static void
+zak_confi_db_plugin_set_children_path (ZakConfiArena *arena, GNode *parentNode, const gchar *path)
+{
+	GNode *node;
+	gchar *path_;
+
+	/* one copy shared by all the children */
+	path = zak_confi_arena_intern (arena, path);
+	for (node = parentNode->children; node != NULL; node = node->next)
+		{
+			ZakConfiKey *ck = (ZakConfiKey *)node->data;
+
+			ck->path = (gchar *)path;
+			if (node->children != NULL)
+				{
+					path_ = g_strconcat (path, (g_strcmp0 (path, "") == 0 ? "" : "/"), ck->key, NULL);
+					zak_confi_db_plugin_set_children_path (arena, node, path_);
+					g_free (path_);
+				}
+		}
+}
+
+/* adds to @index (id -> node) and @nodes a node for every row of @dm,
+ * except @idParent, with the keys in @arena */
+static void
+zak_confi_db_plugin_index_rows (ZakConfiPluggable *pluggable, ZakConfiArena *arena, GHashTable *index, GPtrArray *nodes, GdaDataModel *dm, gint idParent)
+{
+	GNode *node;
+	guint i;
+	guint rows;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	rows = gda_data_model_get_n_rows (dm);
+	for (i = 0; i < rows; i++)
+		{
+			ZakConfiKey *ck;
+			gint id;
+
+			id = gdaex_data_model_get_field_value_integer_at (dm, i, "id");
+			if (id == idParent
+			    || g_hash_table_contains (index, GINT_TO_POINTER (id)))
+				{
+					continue;
+				}
+
+			ck = zak_confi_arena_key_new (arena);
+			ck->id_config = priv->id_config;
+			ck->id = id;
+			ck->id_parent = gdaex_data_model_get_field_value_integer_at (dm, i, "id_parent");
+			ck->key = zak_confi_arena_take_intern (arena, gdaex_data_model_get_field_value_stringify_at (dm, i, "key"));
+			ck->value = zak_confi_arena_take_value (arena, gdaex_data_model_get_field_value_stringify_at (dm, i, "value"));
+			ck->description = zak_confi_arena_take_value (arena, gdaex_data_model_get_field_value_stringify_at (dm, i, "description"));
+
+			node = g_node_new (ck);
+			g_ptr_array_add (nodes, node);
+			g_hash_table_insert (index, GINT_TO_POINTER (id), node);
+		}
+}
+
+/* links the indexed @nodes under @parentNode, through an id->node index,
+ * and frees the ones that don't belong to the subtree of @idParent (their
+ * keys stay in @arena until the tree is freed) */
+static void
+zak_confi_db_plugin_link_nodes (ZakConfiArena *arena, GNode *parentNode, gint idParent, const gchar *path, GHashTable *index, GPtrArray *nodes)
+{
+	GHashTableIter iter;
+	GNode *node;
+	GNode *parent;
+	guint i;
+
+	g_hash_table_insert (index, GINT_TO_POINTER (idParent), parentNode);
+
+	/* linking every node to its parent; children keep the ids order */
+	for (i = 0; i < nodes->len; i++)
+		{
+			ZakConfiKey *ck;
+
+			node = (GNode *)g_ptr_array_index (nodes, i);
+			ck = (ZakConfiKey *)node->data;
+
+			parent = (ck->id_parent != ck->id ? g_hash_table_lookup (index, GINT_TO_POINTER (ck->id_parent)) : NULL);
+			if (parent != NULL)
+				{
+					g_node_append (parent, node);
+				}
+		}
+
+	/* dropping the nodes that don't belong to the requested subtree */
+	g_ptr_array_set_size (nodes, 0);
+	g_hash_table_remove (index, GINT_TO_POINTER (idParent));
+	g_hash_table_iter_init (&iter, index);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&node))
+		{
+			if (G_NODE_IS_ROOT (node))
+				{
+					g_ptr_array_add (nodes, node);
+				}
+		}
+	for (i = 0; i < nodes->len; i++)
+		{
+			node = (GNode *)g_ptr_array_index (nodes, i);
+			g_node_destroy (node);
+		}
+
+	zak_confi_db_plugin_set_children_path (arena, parentNode, path);
+}
+
+/* reads every key of the configuration with only one query and builds
+ * in memory, through an id->node index, the subtree under @idParent; the
+ * keys go in the arena of @parentNode's tree */
+static void
+zak_confi_db_plugin_get_children (ZakConfiPluggable *pluggable, GNode *parentNode, gint idParent, const gchar *path)
+{
+	GdaStatement *stmt;
+	GdaSet *params;
+	GdaDataModel *dm;
+
+	ZakConfiArena *arena;
+	GHashTable *index;
+	GPtrArray *nodes;
+
+	arena = zak_confi_arena_get (parentNode);
+	g_return_if_fail (arena != NULL);
+
+	stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_KEYS_ALL, &params);
+	if (stmt == NULL)
+		{
+			return;
+		}
+
+	dm = zak_confi_db_plugin_select (pluggable, stmt, params);
+	if (dm == NULL)
+		{
+			return;
+		}
+
+	index = g_hash_table_new (g_direct_hash, g_direct_equal);
+	nodes = g_ptr_array_sized_new (gda_data_model_get_n_rows (dm));
+	zak_confi_db_plugin_index_rows (pluggable, arena, index, nodes, dm, idParent);
+	g_object_unref (dm);
+
+	zak_confi_db_plugin_link_nodes (arena, parentNode, idParent, path, index, nodes);
+
+	g_ptr_array_free (nodes, TRUE);
+	g_hash_table_destroy (index);
+}
+
+/* reads only the keys under @idParent, down to @max_depth levels (all if
+ * negative): with one recursive query where the provider supports WITH
+ * RECURSIVE, otherwise with one query per level */
+static void
+zak_confi_db_plugin_get_branch (ZakConfiPluggable *pluggable, GNode *parentNode, gint idParent, const gchar *path, gint max_depth)
+{
+	GdaStatement *stmt;
+	GdaSet *params;
+	GdaDataModel *dm;
+
+	ZakConfiArena *arena;
+	GHashTable *index;
+	GPtrArray *nodes;
+	GString *sql;
+	guint level;
+	guint first;
+	guint i;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (max_depth == 0)
+		{
+			return;
+		}
+
+	arena = zak_confi_arena_get (parentNode);
+	g_return_if_fail (arena != NULL);
+
+	index = g_hash_table_new (g_direct_hash, g_direct_equal);
+	nodes = g_ptr_array_new ();
+
+	if (priv->recursive_cte)
+		{
+			stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_KEYS_BRANCH, &params);
+			if (stmt != NULL)
+				{
+					gda_set_set_holder_value (params, NULL, "id_parent", idParent);
+					gda_set_set_holder_value (params, NULL, "max_depth", (max_depth < 0 ? G_MAXINT : max_depth));
+					dm = zak_confi_db_plugin_select (pluggable, stmt, params);
+					if (dm != NULL)
+						{
+							zak_confi_db_plugin_index_rows (pluggable, arena, index, nodes, dm, idParent);
+							g_object_unref (dm);
+						}
+				}
+		}
+	else
+		{
+			/* the ids of the previous level are nodes[first..len) */
+			first = 0;
+			for (level = 1; max_depth < 0 || level <= (guint)max_depth; level++)
+				{
+					sql = g_string_new ("SELECT * FROM \"values\""
+					                    " WHERE id_configs = ##id_configs::gint"
+					                    " AND id_parent IN (");
+					if (level == 1)
+						{
+							g_string_append_printf (sql, "%d", idParent);
+						}
+					else
+						{
+							for (i = first; i < nodes->len; i++)
+								{
+									g_string_append_printf (sql, "%s%d",
+									                        (i == first ? "" : ", "),
+									                        ((ZakConfiKey *)((GNode *)g_ptr_array_index (nodes, i))->data)->id);
+								}
+						}
+					g_string_append (sql, ") ORDER BY id");
+
+					dm = NULL;
+					stmt = zak_confi_db_plugin_prepare (pluggable, sql->str, &params);
+					g_string_free (sql, TRUE);
+					if (stmt != NULL)
+						{
+							dm = zak_confi_db_plugin_select (pluggable, stmt, params);
+							g_object_unref (stmt);
+							if (params != NULL)
+								{
+									g_object_unref (params);
+								}
+						}
+					if (dm == NULL)
+						{
+							break;
+						}
+
+					i = nodes->len;
+					zak_confi_db_plugin_index_rows (pluggable, arena, index, nodes, dm, idParent);
+					g_object_unref (dm);
+
+					first = i;
+					if (first == nodes->len)
+						{
+							break;
+						}
+				}
+		}
+
+	zak_confi_db_plugin_link_nodes (arena, parentNode, idParent, path, index, nodes);
+
+	g_ptr_array_free (nodes, TRUE);
+	g_hash_table_destroy (index);
+}
+
+typedef struct
+	{
+		GdaDataModel *dm;
+		GdaDataModelIter *iter;
+		gchar *path;
+		gchar *value;
+	} ZakConfiDBIter;
+
+/* the keys under @prefix are read through a forward-only cursor, sorted
+ * by the bytes of their paths by the database; without WITH RECURSIVE returns NULL and
+ * ZakConfi walks the tree; a missing @prefix gives an empty iterator */
+static gpointer
+zak_confi_db_plugin_iter_new (ZakConfiPluggable *pluggable, const gchar *prefix)
+{
+	ZakConfiDBIter *iter;
+	GdaStatement *stmt;
+	GdaSet *params;
+	GdaDataModel *dm;
+	gchar *prefix_;
+	gint id;
+	GError *error;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (!priv->recursive_cte || prefix == NULL)
+		{
+			return NULL;
+		}
+
+	id = 0;
+	if (g_strcmp0 (prefix, "/") != 0)
+		{
+			dm = zak_confi_db_plugin_path_get_data_model (pluggable, prefix);
+			if (dm == NULL || gda_data_model_get_n_rows (dm) == 0)
+				{
+					if (dm != NULL)
+						{
+							g_object_unref (dm);
+						}
+					return g_slice_new0 (ZakConfiDBIter);
+				}
+			id = gdaex_data_model_get_field_value_integer_at (dm, 0, "id");
+			g_object_unref (dm);
+		}
+
+	stmt = zak_confi_db_plugin_get_statement (pluggable, (priv->collate_c ? STMT_KEYS_PATHS_C : STMT_KEYS_PATHS), &params);
+	if (stmt == NULL)
+		{
+			return NULL;
+		}
+
+	prefix_ = g_strconcat (prefix, (g_strcmp0 (prefix, "/") == 0 ? "" : "/"), NULL);
+	gda_set_set_holder_value (params, NULL, "id_configs", priv->id_config);
+	gda_set_set_holder_value (params, NULL, "id_parent", id);
+	zak_confi_db_plugin_set_param_string (params, "prefix", prefix_);
+	g_free (prefix_);
+
+	error = NULL;
+	zak_confi_db_plugin_connection_enter (pluggable);
+	dm = gda_connection_statement_execute_select_full (gdaex_get_gdaconnection (priv->gdaex),
+	                                                   stmt, params,
+	                                                   GDA_STATEMENT_MODEL_CURSOR_FORWARD,
+	                                                   NULL, &error);
+	zak_confi_db_plugin_connection_leave (pluggable);
+	if (dm == NULL || error != NULL)
+		{
+			g_warning ("Error on executing the query: %s.",
+			           error != NULL && error->message != NULL ? error->message : "no details");
+			if (dm != NULL)
+				{
+					g_object_unref (dm);
+				}
+			if (error != NULL)
+				{
+					g_error_free (error);
+				}
+			return NULL;
+		}
+
+	iter = g_slice_new0 (ZakConfiDBIter);
+	iter->dm = dm;
+	iter->iter = gda_data_model_create_iter (dm);
+
+	return iter;
+}
+
+static gboolean
+zak_confi_db_plugin_iter_next (ZakConfiPluggable *pluggable, gpointer data, const gchar **path, const gchar **value)
+{
+	const GValue *gval;
+
+	ZakConfiDBIter *iter = (ZakConfiDBIter *)data;
+
+	g_free (iter->path);
+	g_free (iter->value);
+	iter->path = NULL;
+	iter->value = NULL;
+
+	if (iter->iter == NULL
+	    || !gda_data_model_iter_move_next (iter->iter))
+		{
+			return FALSE;
+		}
+
+	gval = gda_data_model_iter_get_value_at (iter->iter, 0);
+	iter->path = (gval != NULL && !gda_value_is_null (gval) ? gda_value_stringify (gval) : g_strdup (""));
+	gval = gda_data_model_iter_get_value_at (iter->iter, 1);
+	iter->value = (gval != NULL && !gda_value_is_null (gval) ? gda_value_stringify (gval) : NULL);
+
+	*path = iter->path;
+	*value = iter->value;
+
+	return TRUE;
+}
+
+static void
+zak_confi_db_plugin_iter_free (ZakConfiPluggable *pluggable, gpointer data)
+{
+	ZakConfiDBIter *iter = (ZakConfiDBIter *)data;
+
+	if (iter->iter != NULL)
+		{
+			g_object_unref (iter->iter);
+		}
+	if (iter->dm != NULL)
+		{
+			g_object_unref (iter->dm);
+		}
+	g_free (iter->path);
+	g_free (iter->value);
+	g_slice_free (ZakConfiDBIter, iter);
+}
+
+static GList
+*zak_confi_db_plugin_get_configs_list (ZakConfiPluggable *pluggable,
+                                   const gchar *filter)
+{
+	GList *lst;
+
+	GdaDataModel *dmZakConfigs;
+
+	GdaStatement *stmt;
+	GdaSet *params;
+	gchar *filter_;
+
+	guint row;
+	guint rows;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	lst = NULL;
+
+	if (priv->gdaex == NULL)
+		{
+			return NULL;
+		}
+
+	filter_ = g_strstrip (g_strdup (filter != NULL ? filter : ""));
+	if (strcmp (filter_, "") != 0)
+		{
+			stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_CONFIGS_LIST_FILTER, &params);
+			if (stmt != NULL)
+				{
+					zak_confi_db_plugin_set_param_string (params, "filter", filter);
+				}
+		}
+	else
+		{
+			stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_CONFIGS_LIST, &params);
+		}
+	g_free (filter_);
+
+	dmZakConfigs = (stmt != NULL ? zak_confi_db_plugin_select (pluggable, stmt, params) : NULL);
+	if (dmZakConfigs != NULL)
+		{
+			rows = gda_data_model_get_n_rows (dmZakConfigs);
+			if (rows > 0)
+				{
+					for (row = 0; row < rows; row++)
+						{
+							ZakConfiConfi *confi;
+							confi = g_new0 (ZakConfiConfi, 1);
+							confi->name = gdaex_data_model_get_field_value_stringify_at (dmZakConfigs, row, "name");
+							confi->description = gdaex_data_model_get_field_value_stringify_at (dmZakConfigs, row, "description");
+							lst = g_list_append (lst, confi);
+						}
+				}
+			else
+				{
+					lst = g_list_append (lst, NULL);
+				}
+			g_object_unref (dmZakConfigs);
+		}
+
+	return lst;
+}
+
+static gchar
+*zak_confi_db_plugin_path_get_value (ZakConfiPluggable *pluggable, const gchar *path)
+{
+	gchar *ret;
+	gchar *path_;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	ret = NULL;
+
+	path_ = zak_confi_path_normalize (pluggable, path);
+	if (path_ == NULL)
+		{
+			return NULL;
+		}
+
+	ret = zak_confi_db_plugin_path_get_value_from_db (pluggable, path_);
+
+	return ret;
+}
+
+/* reads every row whose key is a segment of one of @paths, with one
+ * query every ZAK_CONFI_DB_PLUGIN_KEYS_BATCH distinct segments, then
+ * resolves the paths in memory through a (parent, key) index */
+static GHashTable
+*zak_confi_db_plugin_paths_get_values (ZakConfiPluggable *pluggable, const gchar **paths)
+{
+	GHashTable *ret;
+	GHashTable *segments;
+	GPtrArray *names;
+	GHashTable *index;
+	GHashTable *values;
+	GdaStatement *stmt;
+	GdaSet *params;
+	GdaDataModel *dm;
+	gchar **tokens;
+	gchar *path_;
+	gchar *segment;
+	gchar *key_;
+	gchar param[16];
+	gpointer num;
+	gboolean found;
+	gint id;
+	gint row;
+	guint first;
+	guint batch;
+	guint size;
+	guint i;
+	guint t;
+
+	ret = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+	if (paths == NULL || paths[0] == NULL)
+		{
+			return ret;
+		}
+
+	/* every distinct segment */
+	segments = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	names = g_ptr_array_new ();
+	for (i = 0; paths[i] != NULL; i++)
+		{
+			path_ = zak_confi_path_normalize (pluggable, paths[i]);
+			if (path_ == NULL)
+				{
+					continue;
+				}
+			tokens = g_strsplit (path_, "/", 0);
+			for (t = 0; tokens[t] != NULL; t++)
+				{
+					segment = g_strstrip (tokens[t]);
+					if (strcmp (segment, "") != 0
+					    && !g_hash_table_contains (segments, segment))
+						{
+							segment = g_strdup (segment);
+							g_hash_table_add (segments, segment);
+							g_ptr_array_add (names, segment);
+						}
+				}
+			g_strfreev (tokens);
+			g_free (path_);
+		}
+
+	/* "id_parent/key" -> id, and id -> value */
+	index = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	values = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+
+	for (first = 0; first < names->len; first += batch)
+		{
+			batch = MIN (names->len - first, ZAK_CONFI_DB_PLUGIN_KEYS_BATCH);
+			stmt = zak_confi_db_plugin_get_in_statement (pluggable, batch, &size, &params);
+			if (stmt == NULL)
+				{
+					break;
+				}
+
+			for (i = 0; i < size; i++)
+				{
+					g_snprintf (param, sizeof (param), "k%u", i + 1);
+					zak_confi_db_plugin_set_param_string (params, param, g_ptr_array_index (names, first + MIN (i, batch - 1)));
+				}
+			dm = zak_confi_db_plugin_select (pluggable, stmt, params);
+			if (dm == NULL)
+				{
+					break;
+				}
+
+			for (row = 0; row < gda_data_model_get_n_rows (dm); row++)
+				{
+					id = gdaex_data_model_get_field_value_integer_at (dm, row, "id");
+					segment = gdaex_data_model_get_field_value_stringify_at (dm, row, "key");
+					g_hash_table_insert (index,
+					                     g_strdup_printf ("%d/%s",
+					                                      gdaex_data_model_get_field_value_integer_at (dm, row, "id_parent"),
+					                                      segment),
+					                     GINT_TO_POINTER (id));
+					g_hash_table_insert (values,
+					                     GINT_TO_POINTER (id),
+					                     gdaex_data_model_get_field_value_stringify_at (dm, row, "value"));
+					g_free (segment);
+				}
+			g_object_unref (dm);
+		}
+
+	g_ptr_array_free (names, TRUE);
+	g_hash_table_destroy (segments);
+
+	for (i = 0; paths[i] != NULL; i++)
+		{
+			path_ = zak_confi_path_normalize (pluggable, paths[i]);
+			if (path_ == NULL)
+				{
+					continue;
+				}
+
+			found = FALSE;
+			id = 0;
+			tokens = g_strsplit (path_, "/", 0);
+			for (t = 0; tokens[t] != NULL; t++)
+				{
+					segment = g_strstrip (tokens[t]);
+					if (strcmp (segment, "") != 0)
+						{
+							key_ = g_strdup_printf ("%d/%s", id, segment);
+							found = g_hash_table_lookup_extended (index, key_, NULL, &num);
+							g_free (key_);
+							if (!found)
+								{
+									break;
+								}
+							id = GPOINTER_TO_INT (num);
+						}
+				}
+			g_strfreev (tokens);
+			g_free (path_);
+
+			if (found)
+				{
+					g_hash_table_replace (ret, g_strdup (paths[i]), g_strdup (g_hash_table_lookup (values, GINT_TO_POINTER (id))));
+				}
+		}
+
+	g_hash_table_destroy (index);
+	g_hash_table_destroy (values);
+
+	return ret;
+}
+
+/* bumps the revision of the configuration, that the following writes
+ * assign to the rows they touch; outside of a transaction opens one,
+ * so the writers are serialized on the configs row */
+static gboolean
+zak_confi_db_plugin_write_begin (ZakConfiPluggable *pluggable)
+{
+	GdaStatement *stmt;
+	GdaSet *params;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	priv->write_transaction = FALSE;
+	if (!priv->transaction)
+		{
+			if (!zak_confi_db_plugin_transaction_begin (pluggable))
+				{
+					return FALSE;
+				}
+			priv->write_transaction = TRUE;
+		}
+
+	stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_CONFIG_BUMP_REVISION, &params);
+	if (stmt == NULL
+	    || zak_confi_db_plugin_execute (pluggable, stmt, params) < 0)
+		{
+			if (priv->write_transaction)
+				{
+					zak_confi_db_plugin_transaction_end (pluggable, FALSE);
+					priv->write_transaction = FALSE;
+				}
+			return FALSE;
+		}
+
+	return TRUE;
+}
+
+static gboolean
+zak_confi_db_plugin_write_end (ZakConfiPluggable *pluggable, gboolean ok)
+{
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (priv->write_transaction)
+		{
+			priv->write_transaction = FALSE;
+			if (!zak_confi_db_plugin_transaction_end (pluggable, ok))
+				{
+					ok = FALSE;
+				}
+		}
+
+	return ok;
+}
+
+static gboolean
+zak_confi_db_plugin_id_set_value (ZakConfiPluggable *pluggable, gint id, const gchar *value)
+{
+	GdaStatement *stmt;
+	GdaSet *params;
+
+	stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_KEY_SET_VALUE, &params);
+	if (stmt == NULL)
+		{
+			return FALSE;
+		}
+
+	gda_set_set_holder_value (params, NULL, "id", id);
+	zak_confi_db_plugin_set_param_string (params, "value", value);
+
+	/* no rows: the key was removed since its id was read */
+	return (zak_confi_db_plugin_execute (pluggable, stmt, params) > 0);
+}
+
+static gboolean
+zak_confi_db_plugin_path_set_value (ZakConfiPluggable *pluggable, const gchar *path, const gchar *value)
+{
+	GdaDataModel *dm;
+	gchar *path_;
+	gboolean ret;
+
+	path_ = zak_confi_path_normalize (pluggable, path);
+	dm = zak_confi_db_plugin_path_get_data_model (pluggable, path_);
+	g_free (path_);
+
+	ret = FALSE;
+	if (dm != NULL && gda_data_model_get_n_rows (dm) > 0)
+		{
+			if (zak_confi_db_plugin_write_begin (pluggable))
+				{
+					ret = zak_confi_db_plugin_id_set_value (pluggable, gdaex_data_model_get_field_value_integer_at (dm, 0, "id"), value);
+					ret = zak_confi_db_plugin_write_end (pluggable, ret);
+				}
+		}
+	else
+		{
+			g_warning ("Path %s doesn't exists.", path);
+		}
+	if (dm != NULL)
+		{
+			g_object_unref (dm);
+		}
+
+	return ret;
+}
+
+/* on a miss, finds also the topmost missing key of @path, whose whole
+ * subtree is then known to be absent: the probe statement returns how
+ * deep the path matched, in the same round trip */
+static gchar
+*zak_confi_db_plugin_path_lookup_value (ZakConfiPluggable *pluggable, const gchar *path, gchar **absent)
+{
+	GdaDataModel *dm;
+	gchar *path_;
+	gchar *end;
+	gchar *ret;
+	guint skip;
+	guint depth;
+	guint matched;
+
+	path_ = zak_confi_path_normalize (pluggable, path);
+	if (path_ == NULL)
+		{
+			return NULL;
+		}
+
+	ret = NULL;
+	skip = 0;
+	depth = 0;
+	matched = 0;
+	dm = zak_confi_db_plugin_path_query (pluggable, path_, TRUE, TRUE, &skip, &depth);
+	if (dm != NULL)
+		{
+			matched = (guint)gdaex_data_model_get_field_value_integer_at (dm, 0, "lvl");
+			if (matched == depth)
+				{
+					ret = gdaex_data_model_get_field_value_stringify_at (dm, 0, "value");
+				}
+			g_object_unref (dm);
+		}
+
+	if (matched == depth
+	    || depth == 0
+	    || absent == NULL)
+		{
+			g_free (path_);
+			return ret;
+		}
+
+	/* cutting after the first segment not matched */
+	end = path_ + skip;
+	for (matched++; matched > 0; matched--)
+		{
+			while (*end == '/')
+				{
+					end++;
+				}
+			while (*end != '\0' && *end != '/')
+				{
+					end++;
+				}
+		}
+	*end = '\0';
+	*absent = path_;
+
+	return NULL;
+}
+
+static gint
+zak_confi_db_plugin_path_get_key_id (ZakConfiPluggable *pluggable, const gchar *path)
+{
+	GdaDataModel *dm;
+	gint ret;
+
+	ret = -1;
+	dm = zak_confi_db_plugin_path_get_data_model (pluggable, path);
+	if (dm != NULL)
+		{
+			if (gda_data_model_get_n_rows (dm) > 0)
+				{
+					ret = gdaex_data_model_get_field_value_integer_at (dm, 0, "id");
+				}
+			g_object_unref (dm);
+		}
+
+	return ret;
+}
+
+static gchar
+*zak_confi_db_plugin_key_id_get_value (ZakConfiPluggable *pluggable, gint id)
+{
+	GdaStatement *stmt;
+	GdaSet *params;
+	GdaDataModel *dm;
+	gchar *ret;
+
+	stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_KEY_VALUE_BY_ID, &params);
+	if (stmt == NULL)
+		{
+			return NULL;
+		}
+
+	gda_set_set_holder_value (params, NULL, "id", id);
+
+	ret = NULL;
+	dm = zak_confi_db_plugin_select (pluggable, stmt, params);
+	if (dm != NULL)
+		{
+			if (gda_data_model_get_n_rows (dm) > 0)
+				{
+					ret = gdaex_data_model_get_field_value_stringify_at (dm, 0, "value");
+				}
+			g_object_unref (dm);
+		}
+
+	return ret;
+}
+
+static gboolean
+zak_confi_db_plugin_key_id_set_value (ZakConfiPluggable *pluggable, gint id, const gchar *value)
+{
+	gboolean ret;
+
+	ret = FALSE;
+	if (zak_confi_db_plugin_write_begin (pluggable))
+		{
+			ret = zak_confi_db_plugin_id_set_value (pluggable, id, value);
+			ret = zak_confi_db_plugin_write_end (pluggable, ret);
+		}
+
+	return ret;
+}
+
+GNode
+*zak_confi_db_plugin_get_tree (ZakConfiPluggable *pluggable)
+{
+	GNode *node;
+	ZakConfiArena *arena;
+	ZakConfiKey *ck;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	arena = zak_confi_arena_new ();
+	zak_confi_arena_set_intern_values (arena, priv->intern_values);
+
+	ck = zak_confi_arena_key_new (arena);
+	ck->id_config = priv->id_config;
+	ck->id = 0;
+	ck->id_parent = 0;
+	ck->path = zak_confi_arena_intern (arena, "");
+	ck->description = zak_confi_arena_intern (arena, "");
+	ck->key = zak_confi_arena_intern (arena, "/");
+	ck->value = zak_confi_arena_intern (arena, "");
+
+	node = zak_confi_arena_new_tree (arena, ck);
+
+	zak_confi_db_plugin_get_children (pluggable, node, 0, "");
+
+	return node;
+}
+
+static GNode
+*zak_confi_db_plugin_get_subtree (ZakConfiPluggable *pluggable, const gchar *path, gint max_depth)
+{
+	GNode *node;
+	GdaDataModel *dm;
+	ZakConfiArena *arena;
+	ZakConfiKey *ck;
+	const gchar *path_;
+	gchar *parent;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (path == NULL)
+		{
+			return NULL;
+		}
+
+	/* the paths of the keys don't have the leading '/' */
+	path_ = path;
+	while (path_[0] == '/')
+		{
+			path_++;
+		}
+
+	arena = zak_confi_arena_new ();
+	zak_confi_arena_set_intern_values (arena, priv->intern_values);
+
+	ck = zak_confi_arena_key_new (arena);
+	ck->id_config = priv->id_config;
+	if (path_[0] == '\0')
+		{
+			ck->id = 0;
+			ck->id_parent = 0;
+			ck->path = zak_confi_arena_intern (arena, "");
+			ck->description = zak_confi_arena_intern (arena, "");
+			ck->key = zak_confi_arena_intern (arena, "/");
+			ck->value = zak_confi_arena_intern (arena, "");
+		}
+	else
+		{
+			dm = zak_confi_db_plugin_path_get_data_model (pluggable, path);
+			if (dm == NULL || gda_data_model_get_n_rows (dm) == 0)
+				{
+					if (dm != NULL)
+						{
+							g_object_unref (dm);
+						}
+					zak_confi_arena_free (arena);
+					return NULL;
+				}
+
+			ck->id = gdaex_data_model_get_field_value_integer_at (dm, 0, "id");
+			ck->id_parent = gdaex_data_model_get_field_value_integer_at (dm, 0, "id_parent");
+			ck->key = zak_confi_arena_take_intern (arena, gdaex_data_model_get_field_value_stringify_at (dm, 0, "key"));
+			ck->value = zak_confi_arena_take_value (arena, gdaex_data_model_get_field_value_stringify_at (dm, 0, "value"));
+			ck->description = zak_confi_arena_take_value (arena, gdaex_data_model_get_field_value_stringify_at (dm, 0, "description"));
+			g_object_unref (dm);
+
+			parent = g_path_get_dirname (path_);
+			ck->path = zak_confi_arena_intern (arena, g_strcmp0 (parent, ".") == 0 ? "" : parent);
+			g_free (parent);
+		}
+
+	node = zak_confi_arena_new_tree (arena, ck);
+
+	zak_confi_db_plugin_get_branch (pluggable, node, ck->id, path_, max_depth);
 
 	return node;
 }
 
+/* returns a new key id from the block reserved for this plugin, reserving
+ * another one when used up; it must be called inside the write
+ * transaction, as the reservation locks the config's row until its end
+ * so concurrent writers get different blocks */
+static gint
+zak_confi_db_plugin_next_id (ZakConfiPluggable *pluggable)
+{
+	GdaStatement *stmt;
+	GdaSet *params;
+	GdaDataModel *dm;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (priv->ids_next >= priv->ids_end)
+		{
+			stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_CONFIG_RESERVE_IDS, &params);
+			if (stmt == NULL)
+				{
+					return -1;
+				}
+			gda_set_set_holder_value (params, NULL, "n", ZAK_CONFI_DB_PLUGIN_IDS_BLOCK);
+			if (zak_confi_db_plugin_execute (pluggable, stmt, params) < 0)
+				{
+					g_warning ("Unable to reserve the key ids; a database created by an older version must be upgraded with confi-upgrade.sql.");
+					return -1;
+				}
+
+			stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_CONFIG_NEXT_ID, &params);
+			dm = (stmt != NULL ? zak_confi_db_plugin_select (pluggable, stmt, params) : NULL);
+			if (dm == NULL)
+				{
+					return -1;
+				}
+			if (gda_data_model_get_n_rows (dm) > 0)
+				{
+					priv->ids_end = gdaex_data_model_get_value_integer_at (dm, 0, 0);
+					priv->ids_next = priv->ids_end - ZAK_CONFI_DB_PLUGIN_IDS_BLOCK;
+				}
+			g_object_unref (dm);
+
+			if (priv->ids_next >= priv->ids_end)
+				{
+					return -1;
+				}
+		}
+
+	return priv->ids_next++;
+}
+
 static ZakConfiKey
-*zak_confi_db_plugin_add_key (ZakConfiPluggable *pluggable, const gchar *parent, const gchar *key, const gchar *value)
+*zak_confi_db_plugin_add_key_real (ZakConfiPluggable *pluggable, const gchar *parent, const gchar *key, const gchar *value)
 {
 	ZakConfiKey *ck;
 	GdaDataModel *dmParent;
 
-	gchar *sql;
+	GdaStatement *stmt;
+	GdaSet *params;
 	gint id;
 	GdaDataModel *dm;
 
@@ -533,11 +2354,11 @@ static ZakConfiKey
 
 	gint id_parent;
 	gchar *parent_;
+	gchar *path_;
 	gchar *key_;
 
-	gchar *path;
-
 	ck = NULL;
+	parent_ = NULL;
 	if (parent == NULL)
 		{
 			id_parent = 0;
@@ -551,7 +2372,9 @@ static ZakConfiKey
 				}
 			else
 				{
-					dmParent = zak_confi_db_plugin_path_get_data_model (pluggable, zak_confi_path_normalize (pluggable, parent_));
+					path_ = zak_confi_path_normalize (pluggable, parent_);
+					dmParent = zak_confi_db_plugin_path_get_data_model (pluggable, path_);
+					g_free (path_);
 					if (dmParent == NULL)
 						{
 							id_parent = -1;
@@ -559,6 +2382,7 @@ static ZakConfiKey
 					else
 						{
 							id_parent = gdaex_data_model_get_field_value_integer_at (dmParent, 0, "id");
+							g_object_unref (dmParent);
 						}
 				}
 		}
@@ -569,85 +2393,61 @@ static ZakConfiKey
 			g_strstrip (key_);
 
 			/* find if key exists */
-			sql = g_strdup_printf ("SELECT id"
-			                       " FROM %cvalues%c"
-			                       " WHERE id_configs = %d"
-			                       " AND name = '%s'",
-			                       priv->chrquot, priv->chrquot,
-			                       priv->id_config,
-			                       gdaex_strescape (key_, NULL));
-			dm = gdaex_query (priv->gdaex, sql);
-			g_free (sql);
+			dm = NULL;
+			stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_KEY_BY_PARENT, &params);
+			if (stmt != NULL)
+				{
+					gda_set_set_holder_value (params, NULL, "id_parent", id_parent);
+					zak_confi_db_plugin_set_param_string (params, "key", key_);
+					dm = zak_confi_db_plugin_select (pluggable, stmt, params);
+				}
 			if (dm != NULL && gda_data_model_get_n_rows (dm) > 0)
 				{
-					g_free (sql);
-					id = gdaex_data_model_get_value_integer_at (dm, 0, 0);
+					id = gdaex_data_model_get_field_value_integer_at (dm, 0, "id");
 					g_object_unref (dm);
 
-					sql = g_strdup_printf ("UPDATE %cvalues%c"
-					                       " SET %ckey%c = '%s',"
-					                       " value = '%s',"
-					                       " WHERE id_configs = %d"
-					                       " AND id = %d",
-					                       priv->chrquot, priv->chrquot,
-					                       priv->chrquot, priv->chrquot,
-					                       gdaex_strescape (key_, NULL),
-					                       gdaex_strescape (ck->value, NULL),
-					                       priv->id_config,
-					                       id);
-					if (gdaex_execute (priv->gdaex, sql) == -1)
+					if (!zak_confi_db_plugin_id_set_value (pluggable, id, value))
 						{
 							/* TO DO */
-							g_free (sql);
+							g_free (key_);
+							g_free (parent_);
 							return NULL;
 						}
-					g_free (sql);
 				}
 			else
 				{
-					g_free (sql);
-					id = 0;
-
-					/* find new id */
-					sql = g_strdup_printf ("SELECT MAX(id)"
-					                       " FROM %cvalues%c"
-					                       " WHERE id_configs = %d",
-					                       priv->chrquot, priv->chrquot,
-					                       priv->id_config);
-					dm = gdaex_query (priv->gdaex, sql);
-					g_free (sql);
 					if (dm != NULL)
 						{
-							id = gdaex_data_model_get_value_integer_at (dm, 0, 0);
 							g_object_unref (dm);
 						}
-					id++;
 
-					sql = g_strdup_printf ("INSERT INTO %cvalues%c"
-					                       " (id_configs, id, id_parent, %ckey%c, value)"
-					                       " VALUES (%d, %d, %d, '%s', '%s')",
-					                       priv->chrquot, priv->chrquot,
-					                       priv->chrquot, priv->chrquot,
-					                       priv->id_config,
-					                       id,
-					                       id_parent,
-					                       gdaex_strescape (key_, NULL),
-					                       "");
-					if (gdaex_execute (priv->gdaex, sql) == -1)
+					id = zak_confi_db_plugin_next_id (pluggable);
+					stmt = (id > 0 ? zak_confi_db_plugin_get_statement (pluggable, STMT_KEY_INSERT, &params) : NULL);
+					if (stmt == NULL)
+						{
+							g_free (key_);
+							g_free (parent_);
+							return NULL;
+						}
+					gda_set_set_holder_value (params, NULL, "id", id);
+					gda_set_set_holder_value (params, NULL, "id_parent", id_parent);
+					zak_confi_db_plugin_set_param_string (params, "key", key_);
+					zak_confi_db_plugin_set_param_string (params, "value", value);
+					if (zak_confi_db_plugin_execute (pluggable, stmt, params) == -1)
 						{
 							/* TO DO */
-							g_free (sql);
+							g_free (key_);
+							g_free (parent_);
 							return NULL;
 						}
-					g_free (sql);
 				}
 
 			ck = g_new0 (ZakConfiKey, 1);
 			ck->id_config = priv->id_config;
 			ck->id = id;
 			ck->id_parent = id_parent;
-			ck->key = g_strdup (key_);
-			ck->value = g_strdup ("");
+			ck->key = key_;
+			ck->value = g_strdup (value);
 			ck->description = g_strdup ("");
 			if (id_parent == 0)
 				{
@@ -657,31 +2457,39 @@ static ZakConfiKey
 				{
 					ck->path = g_strdup (parent_);
 				}
-
-			g_free (key_);
 		}
 	g_free (parent_);
 
-	if (ck != NULL)
+	return ck;
+}
+
+static ZakConfiKey
+*zak_confi_db_plugin_add_key (ZakConfiPluggable *pluggable, const gchar *parent, const gchar *key, const gchar *value)
+{
+	ZakConfiKey *ck;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (!zak_confi_db_plugin_write_begin (pluggable))
 		{
-			if (ck->id_parent != 0)
-				{
-					path = g_strconcat (ck->path, "/", key, NULL);
-				}
-			else
-				{
-					path = g_strdup (ck->key);
-				}
+			return NULL;
+		}
 
-			if (!zak_confi_db_plugin_path_set_value (pluggable, path, value))
-				{
-					ck = NULL;
-				}
-			else
-				{
-					ck->value = g_strdup (value);
-				}
-			g_free (path);
+	ck = zak_confi_db_plugin_add_key_real (pluggable, parent, key, value);
+	if (!zak_confi_db_plugin_write_end (pluggable, ck != NULL) && ck != NULL)
+		{
+			g_free (ck->key);
+			g_free (ck->value);
+			g_free (ck->description);
+			g_free (ck->path);
+			g_free (ck);
+			ck = NULL;
+		}
+
+	/* the root could be just created */
+	if (ck != NULL && priv->root_id == 0)
+		{
+			priv->root_id = -1;
 		}
 
 	return ck;
@@ -692,28 +2500,47 @@ zak_confi_db_plugin_key_set_key (ZakConfiPluggable *pluggable,
                              ZakConfiKey *ck)
 {
 	gboolean ret;
-	gchar *sql;
+	GdaStatement *stmt;
+	GdaSet *params;
+	gchar *path;
+	gchar *slash;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (!zak_confi_db_plugin_write_begin (pluggable))
+		{
+			return FALSE;
+		}
+
+	/* the path before the update, to know if it's a rename */
+	path = zak_confi_db_plugin_key_id_get_path (pluggable, ck->id);
+
+	stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_KEY_SET_KEY, &params);
+	ret = (stmt != NULL);
+	if (ret)
+		{
+			gda_set_set_holder_value (params, NULL, "id", ck->id);
+			zak_confi_db_plugin_set_param_string (params, "key", ck->key);
+			zak_confi_db_plugin_set_param_string (params, "value", ck->value);
+			zak_confi_db_plugin_set_param_string (params, "description", ck->description);
+			ret = (zak_confi_db_plugin_execute (pluggable, stmt, params) > 0);
+		}
 
-	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+	/* a rename removes the old path and moves the whole branch */
+	slash = (path != NULL ? strrchr (path, '/') : NULL);
+	if (ret
+	    && slash != NULL
+	    && g_strcmp0 (slash + 1, ck->key) != 0)
+		{
+			ret = (zak_confi_db_plugin_record_removed (pluggable, path)
+			       && zak_confi_db_plugin_touch_branch (pluggable, ck->id));
+		}
+	g_free (path);
 
-	sql = g_strdup_printf ("UPDATE %cvalues%c"
-	                       " SET %ckey%c = '%s',"
-	                       " value = '%s',"
-	                       " description = '%s'"
-	                       " WHERE id_configs = %d"
-	                       " AND id = %d",
-	                       priv->chrquot, priv->chrquot,
-	                       priv->chrquot, priv->chrquot,
-	                       gdaex_strescape (ck->key, NULL),
-	                       gdaex_strescape (ck->value, NULL),
-	                       gdaex_strescape (ck->description, NULL),
-	                       priv->id_config,
-	                       ck->id);
-
-	ret = (gdaex_execute (priv->gdaex, sql) >= 0);
-	g_free (sql);
+	/* the key could be the root, or one of its parents */
+	priv->root_id = -1;
 
-	return ret;
+	return zak_confi_db_plugin_write_end (pluggable, ret);
 }
 
 static ZakConfiKey
@@ -758,44 +2585,283 @@ static ZakConfiKey
 	return ck;
 }
 
-static gboolean
-zak_confi_db_plugin_delete_id_from_db_values (ZakConfiPluggable *pluggable, gint id)
+/* @sql followed by the ids[first..last) list and ")" */
+static gchar
+*zak_confi_db_plugin_ids_sql (const gchar *sql, GArray *ids, guint first, guint last)
+{
+	GString *sql_;
+	guint i;
+
+	sql_ = g_string_new (sql);
+	for (i = first; i < last; i++)
+		{
+			g_string_append_printf (sql_, "%s%d",
+			                        (i == first ? "" : ", "),
+			                        g_array_index (ids, gint, i));
+		}
+	g_string_append_c (sql_, ')');
+
+	return g_string_free (sql_, FALSE);
+}
+
+/* returns the ids of the key @id and of all its descendants, collected
+ * level by level; NULL on error */
+static GArray
+*zak_confi_db_plugin_get_branch_ids (ZakConfiPluggable *pluggable, gint id)
 {
 	gboolean ret;
+	GdaStatement *stmt;
+	GdaSet *params;
+	GdaDataModel *dm;
+
+	GArray *ids;
+	GHashTable *seen;
 	gchar *sql;
+	gint child;
+	guint first;
+	guint last;
+	guint batch;
+	guint rows;
+	guint i;
 
-	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+	ret = TRUE;
+	ids = g_array_new (FALSE, FALSE, sizeof (gint));
+	seen = g_hash_table_new (g_direct_hash, g_direct_equal);
+	g_array_append_val (ids, id);
+	g_hash_table_add (seen, GINT_TO_POINTER (id));
+
+	/* the ids of the previous level are ids[first..last) */
+	for (first = 0; ret && first < ids->len; first = last)
+		{
+			last = ids->len;
+			for (batch = first; ret && batch < last; batch += ZAK_CONFI_DB_PLUGIN_IDS_BATCH)
+				{
+					sql = zak_confi_db_plugin_ids_sql ("SELECT id FROM \"values\""
+					                                   " WHERE id_configs = ##id_configs::gint"
+					                                   " AND id_parent IN (",
+					                                   ids, batch, MIN (last, batch + ZAK_CONFI_DB_PLUGIN_IDS_BATCH));
+
+					dm = NULL;
+					stmt = zak_confi_db_plugin_prepare (pluggable, sql, &params);
+					g_free (sql);
+					if (stmt != NULL)
+						{
+							dm = zak_confi_db_plugin_select (pluggable, stmt, params);
+							g_object_unref (stmt);
+							if (params != NULL)
+								{
+									g_object_unref (params);
+								}
+						}
+					if (dm == NULL)
+						{
+							ret = FALSE;
+							break;
+						}
 
-	sql = g_strdup_printf ("DELETE FROM %cvalues%c"
-	                       " WHERE id_configs = %d"
-	                       " AND id = %d",
-	                       priv->chrquot, priv->chrquot,
-	                       priv->id_config,
-	                       id);
+					rows = gda_data_model_get_n_rows (dm);
+					for (i = 0; i < rows; i++)
+						{
+							child = gdaex_data_model_get_value_integer_at (dm, i, 0);
+							if (!g_hash_table_contains (seen, GINT_TO_POINTER (child)))
+								{
+									g_hash_table_add (seen, GINT_TO_POINTER (child));
+									g_array_append_val (ids, child);
+								}
+						}
+					g_object_unref (dm);
+				}
+		}
 
-	if (gdaex_execute (priv->gdaex, sql) >= 0)
+	g_hash_table_destroy (seen);
+	if (!ret)
 		{
-			ret = TRUE;
+			g_array_free (ids, TRUE);
+			ids = NULL;
 		}
-	else
+
+	return ids;
+}
+
+/* runs @sql, that ends with "IN (", on @ids in batches */
+static gboolean
+zak_confi_db_plugin_execute_ids (ZakConfiPluggable *pluggable, const gchar *sql, GArray *ids)
+{
+	gboolean ret;
+	GdaStatement *stmt;
+	GdaSet *params;
+	gchar *sql_;
+	guint batch;
+
+	ret = TRUE;
+	for (batch = 0; ret && batch < ids->len; batch += ZAK_CONFI_DB_PLUGIN_IDS_BATCH)
+		{
+			sql_ = zak_confi_db_plugin_ids_sql (sql, ids, batch, MIN (ids->len, batch + ZAK_CONFI_DB_PLUGIN_IDS_BATCH));
+
+			params = NULL;
+			stmt = zak_confi_db_plugin_prepare (pluggable, sql_, &params);
+			g_free (sql_);
+			ret = (stmt != NULL
+			       && zak_confi_db_plugin_execute (pluggable, stmt, params) >= 0);
+			if (stmt != NULL)
+				{
+					g_object_unref (stmt);
+				}
+			if (params != NULL)
+				{
+					g_object_unref (params);
+				}
+		}
+
+	return ret;
+}
+
+/* runs on the key @id with all its descendants @recursive_stmt where the
+ * provider supports WITH RECURSIVE, otherwise @sql (ending with "IN (")
+ * on the ids collected level by level; it must be called inside a
+ * transaction */
+static gboolean
+zak_confi_db_plugin_execute_branch (ZakConfiPluggable *pluggable, gint id, guint recursive_stmt, const gchar *sql)
+{
+	gboolean ret;
+	GdaStatement *stmt;
+	GdaSet *params;
+	GArray *ids;
+
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (priv->recursive_cte)
 		{
-			ret = FALSE;
+			stmt = zak_confi_db_plugin_get_statement (pluggable, recursive_stmt, &params);
+			if (stmt == NULL)
+				{
+					return FALSE;
+				}
+
+			gda_set_set_holder_value (params, NULL, "id", id);
+
+			return (zak_confi_db_plugin_execute (pluggable, stmt, params) >= 0);
 		}
-	g_free (sql);
+
+	ids = zak_confi_db_plugin_get_branch_ids (pluggable, id);
+	if (ids == NULL)
+		{
+			return FALSE;
+		}
+
+	ret = zak_confi_db_plugin_execute_ids (pluggable, sql, ids);
+	g_array_free (ids, TRUE);
 
 	return ret;
 }
 
+/* deletes the key @id with all its descendants */
+static gboolean
+zak_confi_db_plugin_delete_branch (ZakConfiPluggable *pluggable, gint id)
+{
+	return zak_confi_db_plugin_execute_branch (pluggable, id, STMT_KEYS_DELETE_BRANCH,
+	                                           "DELETE FROM \"values\""
+	                                           " WHERE id_configs = ##id_configs::gint"
+	                                           " AND id IN (");
+}
+
+/* stamps the key @id and all its descendants with the current revision,
+ * as their paths changed */
+static gboolean
+zak_confi_db_plugin_touch_branch (ZakConfiPluggable *pluggable, gint id)
+{
+	return zak_confi_db_plugin_execute_branch (pluggable, id, STMT_KEYS_TOUCH_BRANCH,
+	                                           "UPDATE \"values\""
+	                                           " SET revision = (SELECT revision FROM configs WHERE id = ##id_configs::gint)"
+	                                           " WHERE id_configs = ##id_configs::gint"
+	                                           " AND id IN (");
+}
+
+/* records the removal of @path for zak_confi_db_plugin_get_changes_since (),
+ * forgetting the removals too old to be asked for */
 static gboolean
-zak_confi_db_plugin_remove_path_traverse_func (GNode *node, gpointer data)
+zak_confi_db_plugin_record_removed (ZakConfiPluggable *pluggable, const gchar *path)
+{
+	GdaStatement *stmt;
+	GdaSet *params;
+	gint64 revision;
+
+	stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_KEY_REMOVED, &params);
+	if (stmt == NULL)
+		{
+			return FALSE;
+		}
+	zak_confi_db_plugin_set_param_string (params, "path", path);
+	if (zak_confi_db_plugin_execute (pluggable, stmt, params) < 0)
+		{
+			return FALSE;
+		}
+
+	revision = zak_confi_db_plugin_get_revision (pluggable) - ZAK_CONFI_DB_PLUGIN_REMOVED_KEEP;
+	if (revision <= 0)
+		{
+			return TRUE;
+		}
+
+	stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_KEYS_REMOVED_PRUNE, &params);
+	if (stmt == NULL)
+		{
+			return FALSE;
+		}
+	gda_set_set_holder_value (params, NULL, "revision", revision);
+
+	return (zak_confi_db_plugin_execute (pluggable, stmt, params) >= 0);
+}
+
+/* returns the absolute path of the key @id, reading its ancestors one
+ * per query; NULL if not found */
+static gchar
+*zak_confi_db_plugin_key_id_get_path (ZakConfiPluggable *pluggable, gint id)
 {
-	ZakConfiKey *ck = (ZakConfiKey *)node->data;
-	if (ck->id != 0)
+	GdaStatement *stmt;
+	GdaSet *params;
+	GdaDataModel *dm;
+	GString *path;
+	gchar *key;
+	gint id_parent;
+
+	path = g_string_new ("");
+	while (id > 0)
+		{
+			stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_KEY_BY_ID, &params);
+			if (stmt == NULL)
+				{
+					break;
+				}
+			gda_set_set_holder_value (params, NULL, "id", id);
+			dm = zak_confi_db_plugin_select (pluggable, stmt, params);
+			if (dm == NULL || gda_data_model_get_n_rows (dm) == 0)
+				{
+					if (dm != NULL)
+						{
+							g_object_unref (dm);
+						}
+					break;
+				}
+
+			key = gdaex_data_model_get_field_value_stringify_at (dm, 0, "key");
+			g_string_prepend (path, key);
+			g_string_prepend_c (path, '/');
+			g_free (key);
+
+			/* a key that is its own parent is at the top */
+			id_parent = gdaex_data_model_get_field_value_integer_at (dm, 0, "id_parent");
+			g_object_unref (dm);
+			id = (id_parent != id ? id_parent : 0);
+		}
+
+	if (id != 0 || path->len == 0)
 		{
-			zak_confi_db_plugin_delete_id_from_db_values ((ZakConfiPluggable *)data, ck->id);
+			g_string_free (path, TRUE);
+			return NULL;
 		}
 
-	return FALSE;
+	return g_string_free (path, FALSE);
 }
 
 static gboolean
@@ -803,33 +2869,33 @@ zak_confi_db_plugin_remove_path (ZakConfiPluggable *pluggable, const gchar *path
 {
 	gboolean ret = FALSE;
 	GdaDataModel *dm;
+	gchar *path_;
 
 	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
 
-	dm = zak_confi_db_plugin_path_get_data_model (pluggable, zak_confi_path_normalize (pluggable, path));
+	path_ = zak_confi_path_normalize (pluggable, path);
+	dm = zak_confi_db_plugin_path_get_data_model (pluggable, path_);
 
-	if (dm != NULL && gda_data_model_get_n_rows (dm) > 0)
+	if (dm != NULL && gda_data_model_get_n_rows (dm) > 0
+	    && zak_confi_db_plugin_write_begin (pluggable))
 		{
-			gchar *path_ = g_strdup (path);
-
-			/* removing every child key */
-			GNode *node, *root;
 			gint id = gdaex_data_model_get_field_value_integer_at (dm, 0, "id");
 
-			node = g_node_new (path_);
-			zak_confi_db_plugin_get_children (pluggable, node, id, path_);
-
-			root = g_node_get_root (node);
+			/* removing the path with every child key, in the same
+			 * transaction */
+			ret = zak_confi_db_plugin_delete_branch (pluggable, id);
 
-			if (g_node_n_nodes (root, G_TRAVERSE_ALL) > 1)
+			if (ret)
 				{
-					g_node_traverse (root, G_PRE_ORDER, G_TRAVERSE_ALL, -1, zak_confi_db_plugin_remove_path_traverse_func, (gpointer)pluggable);
+					ret = zak_confi_db_plugin_record_removed (pluggable, path_);
 				}
 
-			/* removing the path */
-			ret = zak_confi_db_plugin_delete_id_from_db_values (pluggable, id);
+			ret = zak_confi_db_plugin_write_end (pluggable, ret);
+
+			/* the root could be removed with the path */
+			priv->root_id = -1;
 		}
-	else
+	else if (dm == NULL || gda_data_model_get_n_rows (dm) == 0)
 		{
 			g_warning ("Path %s doesn't exists.", path);
 		}
@@ -837,6 +2903,7 @@ zak_confi_db_plugin_remove_path (ZakConfiPluggable *pluggable, const gchar *path
 		{
 			g_object_unref (dm);
 		}
+	g_free (path_);
 
 	return ret;
 }
@@ -845,31 +2912,303 @@ static gboolean
 zak_confi_db_plugin_remove (ZakConfiPluggable *pluggable)
 {
 	gboolean ret;
-	gchar *sql;
+	GdaStatement *stmt;
+	GdaSet *params;
+
+	ret = FALSE;
+	stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_KEYS_REMOVED_DELETE_ALL, &params);
+	if (stmt == NULL
+	    || zak_confi_db_plugin_execute (pluggable, stmt, params) == -1)
+		{
+			return FALSE;
+		}
+
+	stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_KEYS_DELETE_ALL, &params);
+	if (stmt != NULL
+	    && zak_confi_db_plugin_execute (pluggable, stmt, params) != -1)
+		{
+			stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_CONFIG_DELETE, &params);
+			ret = (stmt != NULL
+			       && zak_confi_db_plugin_execute (pluggable, stmt, params) != -1);
+		}
+
+	return ret;
+}
 
+static gboolean
+zak_confi_db_plugin_begin (ZakConfiPluggable *pluggable)
+{
 	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
 
-	ret = TRUE;
-	sql = g_strdup_printf ("DELETE FROM %cvalues%c WHERE id_configs = %d",
-                           priv->chrquot,
-                           priv->chrquot,
-                           priv->id_config);
-	if (gdaex_execute (priv->gdaex, sql) == -1)
+	if (priv->transaction)
 		{
-			g_free (sql);
-			ret = FALSE;
+			return FALSE;
 		}
-	else
+
+	priv->transaction = zak_confi_db_plugin_transaction_begin (pluggable);
+
+	return priv->transaction;
+}
+
+static gboolean
+zak_confi_db_plugin_commit (ZakConfiPluggable *pluggable)
+{
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (!priv->transaction)
+		{
+			return FALSE;
+		}
+
+	priv->transaction = FALSE;
+
+	return zak_confi_db_plugin_transaction_end (pluggable, TRUE);
+}
+
+static gboolean
+zak_confi_db_plugin_rollback (ZakConfiPluggable *pluggable)
+{
+	ZakConfiDBPluginPrivate *priv = ZAK_CONFI_DB_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (!priv->transaction)
+		{
+			return FALSE;
+		}
+
+	priv->transaction = FALSE;
+	priv->root_id = -1;
+
+	return zak_confi_db_plugin_transaction_end (pluggable, FALSE);
+}
+
+static gint64
+zak_confi_db_plugin_get_revision (ZakConfiPluggable *pluggable)
+{
+	gint64 ret;
+	gchar *revision;
+	GdaStatement *stmt;
+	GdaSet *params;
+	GdaDataModel *dm;
+
+	ret = -1;
+	stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_CONFIG_REVISION, &params);
+	dm = (stmt != NULL ? zak_confi_db_plugin_select (pluggable, stmt, params) : NULL);
+	if (dm != NULL)
+		{
+			if (gda_data_model_get_n_rows (dm) > 0)
+				{
+					revision = gdaex_data_model_get_value_stringify_at (dm, 0, 0);
+					ret = g_ascii_strtoll (revision, NULL, 10);
+					g_free (revision);
+				}
+			g_object_unref (dm);
+		}
+
+	return ret;
+}
+
+static void
+zak_confi_db_plugin_key_free (gpointer data)
+{
+	ZakConfiKey *ck = (ZakConfiKey *)data;
+
+	if (ck != NULL)
+		{
+			g_free (ck->key);
+			g_free (ck->value);
+			g_free (ck);
+		}
+}
+
+/* reads only the rows written after @revision; their paths are resolved
+ * fetching the missing ancestors, one level per query; NULL if @revision
+ * is older than the removals kept or if a query fails, as the changes
+ * would be incomplete */
+static GHashTable
+*zak_confi_db_plugin_get_changes_since (ZakConfiPluggable *pluggable, gint64 revision)
+{
+	GHashTable *ret;
+	GHashTable *index;
+	GHashTableIter iter;
+	GArray *changed;
+	GArray *missing;
+	GString *sql;
+	GString *path;
+	GdaStatement *stmt;
+	GdaSet *params;
+	GdaDataModel *dm;
+	ZakConfiKey *ck;
+	ZakConfiKey *parent;
+	gchar *value;
+	gboolean first;
+	gboolean failed;
+	gint id;
+	gint row;
+	guint i;
+
+	if (revision < zak_confi_db_plugin_get_revision (pluggable) - ZAK_CONFI_DB_PLUGIN_REMOVED_KEEP)
+		{
+			return NULL;
+		}
+
+	stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_KEYS_CHANGED, &params);
+	if (stmt == NULL)
 		{
-			g_free (sql);
-			sql = g_strdup_printf ("DELETE FROM configs WHERE id = %d",
-			                       priv->id_config);
-			if (gdaex_execute (priv->gdaex, sql) == -1)
+			return NULL;
+		}
+	gda_set_set_holder_value (params, NULL, "revision", revision);
+	dm = zak_confi_db_plugin_select (pluggable, stmt, params);
+	if (dm == NULL)
+		{
+			return NULL;
+		}
+
+	ret = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+	/* id -> key; NULL for an id asked for but not found */
+	index = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, zak_confi_db_plugin_key_free);
+	changed = g_array_new (FALSE, FALSE, sizeof (gint));
+	missing = g_array_new (FALSE, FALSE, sizeof (gint));
+	first = TRUE;
+	failed = FALSE;
+	while (dm != NULL)
+		{
+			for (row = 0; row < gda_data_model_get_n_rows (dm); row++)
+				{
+					ck = g_new0 (ZakConfiKey, 1);
+					ck->id = gdaex_data_model_get_field_value_integer_at (dm, row, "id");
+					ck->id_parent = gdaex_data_model_get_field_value_integer_at (dm, row, "id_parent");
+					ck->key = gdaex_data_model_get_field_value_stringify_at (dm, row, "key");
+					if (first)
+						{
+							ck->value = gdaex_data_model_get_field_value_stringify_at (dm, row, "value");
+						}
+					g_hash_table_replace (index, GINT_TO_POINTER (ck->id), ck);
+				}
+			g_object_unref (dm);
+			dm = NULL;
+
+			/* at the first round, the changed rows */
+			if (first)
+				{
+					first = FALSE;
+					g_hash_table_iter_init (&iter, index);
+					while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&ck))
+						{
+							g_array_append_val (changed, ck->id);
+						}
+					if (changed->len == 0)
+						{
+							break;
+						}
+				}
+
+			/* the parents not read yet */
+			g_array_set_size (missing, 0);
+			g_hash_table_iter_init (&iter, index);
+			while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&ck))
+				{
+					if (ck != NULL
+					    && ck->id_parent != 0
+					    && ck->id_parent != ck->id
+					    && !g_hash_table_contains (index, GINT_TO_POINTER (ck->id_parent)))
+						{
+							g_array_append_val (missing, ck->id_parent);
+						}
+				}
+			if (missing->len == 0)
+				{
+					break;
+				}
+
+			sql = g_string_new ("SELECT id, id_parent, \"key\" FROM \"values\""
+			                    " WHERE id_configs = ##id_configs::gint"
+			                    " AND id IN (");
+			for (i = 0; i < missing->len; i++)
+				{
+					id = g_array_index (missing, gint, i);
+					if (!g_hash_table_contains (index, GINT_TO_POINTER (id)))
+						{
+							g_string_append_printf (sql, "%s%d", (sql->str[sql->len - 1] == '(' ? "" : ", "), id);
+							g_hash_table_insert (index, GINT_TO_POINTER (id), NULL);
+						}
+				}
+			g_string_append (sql, ")");
+
+			stmt = zak_confi_db_plugin_prepare (pluggable, sql->str, &params);
+			g_string_free (sql, TRUE);
+			if (stmt != NULL)
+				{
+					dm = zak_confi_db_plugin_select (pluggable, stmt, params);
+					g_object_unref (stmt);
+					if (params != NULL)
+						{
+							g_object_unref (params);
+						}
+				}
+			failed = (dm == NULL);
+		}
+
+	if (failed)
+		{
+			g_array_free (missing, TRUE);
+			g_array_free (changed, TRUE);
+			g_hash_table_destroy (index);
+			g_hash_table_destroy (ret);
+			return NULL;
+		}
+
+	path = g_string_new ("");
+	for (i = 0; i < changed->len; i++)
+		{
+			ck = (ZakConfiKey *)g_hash_table_lookup (index, GINT_TO_POINTER (g_array_index (changed, gint, i)));
+
+			g_string_assign (path, "");
+			for (parent = ck;
+			     parent != NULL;
+			     parent = (parent->id_parent != 0 && parent->id_parent != parent->id ? g_hash_table_lookup (index, GINT_TO_POINTER (parent->id_parent)) : NULL))
+				{
+					g_string_prepend (path, parent->key);
+					g_string_prepend_c (path, '/');
+					if (parent->id_parent == 0)
+						{
+							g_hash_table_replace (ret, g_strdup (path->str), g_strdup (ck->value != NULL ? ck->value : ""));
+						}
+				}
+		}
+	g_string_free (path, TRUE);
+
+	g_array_free (missing, TRUE);
+	g_array_free (changed, TRUE);
+	g_hash_table_destroy (index);
+
+	/* the removed paths, unless written again afterwards */
+	stmt = zak_confi_db_plugin_get_statement (pluggable, STMT_KEYS_REMOVED_SINCE, &params);
+	dm = NULL;
+	if (stmt != NULL)
+		{
+			gda_set_set_holder_value (params, NULL, "revision", revision);
+			dm = zak_confi_db_plugin_select (pluggable, stmt, params);
+		}
+	if (dm == NULL)
+		{
+			g_hash_table_destroy (ret);
+			return NULL;
+		}
+
+	for (row = 0; row < gda_data_model_get_n_rows (dm); row++)
+		{
+			value = gdaex_data_model_get_field_value_stringify_at (dm, row, "path");
+			if (!g_hash_table_contains (ret, value))
+				{
+					g_hash_table_insert (ret, value, NULL);
+				}
+			else
 				{
-					ret = FALSE;
+					g_free (value);
 				}
-			g_free (sql);
 		}
+	g_object_unref (dm);
 
 	return ret;
 }
@@ -889,6 +3228,7 @@ zak_confi_db_plugin_class_init (ZakConfiDBPluginClass *klass)
 	g_object_class_override_property (object_class, PROP_NAME, "name");
 	g_object_class_override_property (object_class, PROP_DESCRIPTION, "description");
 	g_object_class_override_property (object_class, PROP_ROOT, "root");
+	g_object_class_override_property (object_class, PROP_INTERN_VALUES, "intern_values");
 }
 
 static void
@@ -899,11 +3239,25 @@ zak_confi_pluggable_iface_init (ZakConfiPluggableInterface *iface)
 	iface->path_get_value = zak_confi_db_plugin_path_get_value;
 	iface->path_set_value = zak_confi_db_plugin_path_set_value;
 	iface->get_tree = zak_confi_db_plugin_get_tree;
+	iface->get_subtree = zak_confi_db_plugin_get_subtree;
+	iface->path_lookup_value = zak_confi_db_plugin_path_lookup_value;
+	iface->path_get_key_id = zak_confi_db_plugin_path_get_key_id;
+	iface->key_id_get_value = zak_confi_db_plugin_key_id_get_value;
+	iface->key_id_set_value = zak_confi_db_plugin_key_id_set_value;
+	iface->iter_new = zak_confi_db_plugin_iter_new;
+	iface->iter_next = zak_confi_db_plugin_iter_next;
+	iface->iter_free = zak_confi_db_plugin_iter_free;
 	iface->add_key = zak_confi_db_plugin_add_key;
 	iface->key_set_key = zak_confi_db_plugin_key_set_key;
 	iface->path_get_confi_key = zak_confi_db_plugin_path_get_confi_key;
 	iface->remove_path = zak_confi_db_plugin_remove_path;
 	iface->remove = zak_confi_db_plugin_remove;
+	iface->paths_get_values = zak_confi_db_plugin_paths_get_values;
+	iface->begin = zak_confi_db_plugin_begin;
+	iface->commit = zak_confi_db_plugin_commit;
+	iface->rollback = zak_confi_db_plugin_rollback;
+	iface->get_revision = zak_confi_db_plugin_get_revision;
+	iface->get_changes_since = zak_confi_db_plugin_get_changes_since;
 }
 
 static void
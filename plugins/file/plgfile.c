@@ -44,7 +44,15 @@ static gboolean zak_confi_file_plugin_path_get_group_and_key (const gchar *path,
 static gchar *zak_confi_file_plugin_path_get_value_from_file (ZakConfiPluggable *pluggable, const gchar *path);
 static gchar *zak_confi_file_plugin_path_get_value (ZakConfiPluggable *pluggable, const gchar *path);
 static gboolean zak_confi_file_plugin_path_set_value (ZakConfiPluggable *pluggable, const gchar *path, const gchar *value);
+static gboolean zak_confi_file_plugin_save (ZakConfiPluggable *pluggable);
+static gboolean zak_confi_file_plugin_write (ZakConfiPluggable *pluggable);
+static gpointer zak_confi_file_plugin_save_thread (gpointer data);
 static void zak_confi_file_plugin_get_children (ZakConfiPluggable *pluggable, GNode *parentNode);
+static void zak_confi_file_plugin_on_file_changed (GFileMonitor *monitor,
+                                                   GFile *file,
+                                                   GFile *other_file,
+                                                   GFileMonitorEvent event_type,
+                                                   gpointer user_data);
 
 #define ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE ((obj), ZAK_CONFI_TYPE_FILE_PLUGIN, ZakConfiFilePluginPrivate))
 
@@ -52,12 +60,34 @@ typedef struct _ZakConfiFilePluginPrivate ZakConfiFilePluginPrivate;
 struct _ZakConfiFilePluginPrivate
 	{
 		gchar *cnc_string;
+		gchar *filename;
 
 		GKeyFile *kfile;
 
+		/* deferred saving: mutex protects kfile and the dirty state,
+		 * write_mutex keeps the writes of the file in order */
+		guint save_delay;
+		GMutex mutex;
+		GMutex write_mutex;
+		GCond cond;
+		GThread *save_thread;
+		gboolean save_quit;
+		gboolean dirty;
+		gint64 dirty_time;
+
+		/* the file content at the begin of the transaction */
+		gchar *transaction;
+
+		/* reloading of the file when changed from outside */
+		gboolean monitor_enabled;
+		GFileMonitor *monitor;
+
 		gchar *name;
 		gchar *description;
 		gchar *root;
+
+		/* the trees share also the equal values */
+		gboolean intern_values;
 	};
 
 G_DEFINE_DYNAMIC_TYPE_EXTENDED (ZakConfiFilePlugin,
@@ -72,7 +102,8 @@ enum {
 	PROP_CNC_STRING,
 	PROP_NAME,
 	PROP_DESCRIPTION,
-	PROP_ROOT
+	PROP_ROOT,
+	PROP_INTERN_VALUES
 };
 
 static void
@@ -104,6 +135,10 @@ zak_confi_file_plugin_set_property (GObject      *object,
 				priv->root = zak_confi_normalize_root (g_value_get_string (value));
 				break;
 
+			case PROP_INTERN_VALUES:
+				priv->intern_values = g_value_get_boolean (value);
+				break;
+
 			default:
 				G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 				break;
@@ -137,6 +172,10 @@ zak_confi_file_plugin_get_property (GObject    *object,
 				g_value_set_string (value, priv->root);
 				break;
 
+			case PROP_INTERN_VALUES:
+				g_value_set_boolean (value, priv->intern_values);
+				break;
+
 			default:
 				G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 				break;
@@ -149,15 +188,61 @@ zak_confi_file_plugin_init (ZakConfiFilePlugin *plugin)
 	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (plugin);
 
 	priv->cnc_string = NULL;
+	priv->filename = NULL;
 	priv->kfile = NULL;
+
+	priv->save_delay = 0;
+	g_mutex_init (&priv->mutex);
+	g_mutex_init (&priv->write_mutex);
+	g_cond_init (&priv->cond);
+	priv->save_thread = NULL;
+	priv->save_quit = FALSE;
+	priv->dirty = FALSE;
+	priv->transaction = NULL;
+	priv->monitor_enabled = FALSE;
+	priv->monitor = NULL;
 	priv->name = NULL;
 	priv->description = NULL;
+	priv->intern_values = FALSE;
 }
 
 static void
 zak_confi_file_plugin_finalize (GObject *object)
 {
 	ZakConfiFilePlugin *plugin = ZAK_CONFI_FILE_PLUGIN (object);
+	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (plugin);
+
+	if (priv->monitor != NULL)
+		{
+			g_signal_handlers_disconnect_by_data (priv->monitor, plugin);
+			g_file_monitor_cancel (priv->monitor);
+			g_object_unref (priv->monitor);
+			priv->monitor = NULL;
+		}
+	if (priv->save_thread != NULL)
+		{
+			g_mutex_lock (&priv->mutex);
+			priv->save_quit = TRUE;
+			g_cond_signal (&priv->cond);
+			g_mutex_unlock (&priv->mutex);
+
+			g_thread_join (priv->save_thread);
+			priv->save_thread = NULL;
+		}
+	if (priv->dirty && priv->kfile != NULL)
+		{
+			zak_confi_file_plugin_write ((ZakConfiPluggable *)plugin);
+		}
+
+	if (priv->kfile != NULL)
+		{
+			g_key_file_free (priv->kfile);
+		}
+	g_free (priv->cnc_string);
+	g_free (priv->filename);
+	g_mutex_clear (&priv->mutex);
+	g_mutex_clear (&priv->write_mutex);
+	g_cond_clear (&priv->cond);
 
 	G_OBJECT_CLASS (zak_confi_file_plugin_parent_class)->finalize (object);
 }
@@ -168,14 +253,38 @@ zak_confi_file_plugin_initialize (ZakConfiPluggable *pluggable, const gchar *cnc
 	gboolean ret;
 	GError *error;
 
+	gchar **strs;
+	guint i;
+	GFile *gfile;
+
 	ZakConfiFilePlugin *plugin = ZAK_CONFI_FILE_PLUGIN (pluggable);
 	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (plugin);
 
 	priv->cnc_string = g_strdup (cnc_string);
 
+	/* the file name, optionally followed by ;-separated options:
+	 * SAVE_DELAY=<milliseconds> coalesces the writes of the file in that
+	 * window and does them on a worker thread;
+	 * MONITOR=1 reloads the file when it's changed from outside */
+	strs = g_strsplit (cnc_string, ";", -1);
+	priv->filename = g_strdup (strs[0] != NULL ? strs[0] : "");
+	for (i = 1; strs[0] != NULL && strs[i] != NULL; i++)
+		{
+			if (g_str_has_prefix (strs[i], "SAVE_DELAY="))
+				{
+					priv->save_delay = (guint)g_ascii_strtoull (strs[i] + strlen ("SAVE_DELAY="), NULL, 10);
+				}
+			else if (g_str_has_prefix (strs[i], "MONITOR="))
+				{
+					priv->monitor_enabled = (g_ascii_strtoull (strs[i] + strlen ("MONITOR="), NULL, 10) != 0);
+				}
+		}
+	g_strfreev (strs);
+
+	ret = TRUE;
 	priv->kfile = g_key_file_new ();
 	error = NULL;
-	if (g_key_file_load_from_file (priv->kfile, priv->cnc_string, G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS, &error)
+	if (g_key_file_load_from_file (priv->kfile, priv->filename, G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS, &error)
 	    && error == NULL)
 		{
 			error = NULL;
@@ -185,6 +294,34 @@ zak_confi_file_plugin_initialize (ZakConfiPluggable *pluggable, const gchar *cnc
 					priv->name = g_strdup ("Default");
 				}
 			priv->description = g_key_file_get_value (priv->kfile, "CONFI", "description", NULL);
+
+			if (priv->save_delay > 0 && priv->save_thread == NULL)
+				{
+					priv->save_thread = g_thread_new ("zakconfi-file-save", zak_confi_file_plugin_save_thread, pluggable);
+				}
+
+			/* the events are dispatched in the thread-default main context */
+			if (priv->monitor_enabled && priv->monitor == NULL)
+				{
+					gfile = g_file_new_for_path (priv->filename);
+					error = NULL;
+					priv->monitor = g_file_monitor_file (gfile, G_FILE_MONITOR_NONE, NULL, &error);
+					if (priv->monitor == NULL || error != NULL)
+						{
+							g_warning ("Unable to monitor the file: %s.",
+							           error != NULL && error->message != NULL ? error->message : "no details");
+						}
+					else
+						{
+							g_signal_connect (priv->monitor, "changed",
+							                  G_CALLBACK (zak_confi_file_plugin_on_file_changed), pluggable);
+						}
+					if (error != NULL)
+						{
+							g_error_free (error);
+						}
+					g_object_unref (gfile);
+				}
 		}
 	else
 		{
@@ -242,7 +379,9 @@ static gchar
 		}
 
 	error = NULL;
+	g_mutex_lock (&priv->mutex);
 	ret = g_key_file_get_value (priv->kfile, group, key, &error);
+	g_mutex_unlock (&priv->mutex);
 	if (error != NULL)
 		{
 			if (ret != NULL)
@@ -257,56 +396,89 @@ static gchar
 	return ret;
 }
 
+/* must be called with priv->mutex locked */
+static ZakConfiKey
+*zak_confi_file_plugin_key_new (ZakConfiFilePluginPrivate *priv, ZakConfiArena *arena, const gchar *group, const gchar *key)
+{
+	ZakConfiKey *ck = zak_confi_arena_key_new (arena);
+
+	if (key == NULL)
+		{
+			ck->key = zak_confi_arena_intern (arena, group);
+			ck->value = zak_confi_arena_intern (arena, "");
+			ck->description = zak_confi_arena_intern (arena, "");
+			ck->path = zak_confi_arena_intern (arena, "");
+		}
+	else
+		{
+			ck->key = zak_confi_arena_intern (arena, key);
+			ck->path = zak_confi_arena_intern (arena, group);
+			ck->value = zak_confi_arena_take_value (arena, g_key_file_get_value (priv->kfile, group, key, NULL));
+			ck->description = zak_confi_arena_take_value (arena, g_key_file_get_comment (priv->kfile, group, key, NULL));
+		}
+
+	return ck;
+}
+
+/* must be called with priv->mutex locked */
 static void
-zak_confi_file_plugin_get_children (ZakConfiPluggable *pluggable, GNode *parentNode)
+zak_confi_file_plugin_get_keys (ZakConfiFilePluginPrivate *priv, ZakConfiArena *arena, GNode *gNode, const gchar *group)
 {
-	gchar **groups;
 	gchar **keys;
-	gsize lg;
 	gsize lk;
-	guint g;
 	guint k;
 
 	GError *error;
 
-	GNode *gNode;
-
-	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (pluggable);
-
-	groups = g_key_file_get_groups (priv->kfile, &lg);
+	error = NULL;
+	keys = g_key_file_get_keys (priv->kfile, group, &lk, &error);
+	if (keys != NULL && error == NULL && lk > 0)
+		{
+			for (k = 0; k < lk; k++)
+				{
+					g_node_append_data (gNode, zak_confi_file_plugin_key_new (priv, arena, group, keys[k]));
+				}
+		}
 
-	for (g = 0; g < lg; g++)
+	if (keys != NULL)
 		{
-			ZakConfiKey *ck = g_new0 (ZakConfiKey, 1);
+			g_strfreev (keys);
+		}
+	if (error != NULL)
+		{
+			g_error_free (error);
+		}
+}
+
+/* must be called with priv->mutex locked */
+static GNode
+*zak_confi_file_plugin_group_new (ZakConfiFilePluginPrivate *priv, ZakConfiArena *arena, const gchar *group, gboolean with_keys)
+{
+	GNode *gNode;
 
-			ck->key = g_strdup (groups[g]);
-			ck->value = "";
-			ck->description = "";
-			ck->path = "";
+	gNode = g_node_new (zak_confi_file_plugin_key_new (priv, arena, group, NULL));
 
-			gNode = g_node_append_data (parentNode, ck);
+	if (with_keys)
+		{
+			zak_confi_file_plugin_get_keys (priv, arena, gNode, group);
+		}
 
-			error = NULL;
-			keys = g_key_file_get_keys (priv->kfile, groups[g], &lk, &error);
-			if (keys != NULL && error == NULL && lk > 0)
-				{
-					for (k = 0; k < lk; k++)
-						{
-							ZakConfiKey *ck = g_new0 (ZakConfiKey, 1);
+	return gNode;
+}
 
-							ck->key = g_strdup (keys[k]);
-							ck->path = g_strdup (groups[g]);
-							ck->value = zak_confi_file_plugin_path_get_value (pluggable, g_strdup_printf ("%s/%s", groups[g], keys[k]));
-							ck->description = g_key_file_get_comment (priv->kfile, groups[g], keys[k], NULL);
+/* must be called with priv->mutex locked; the keys go in @arena */
+static void
+zak_confi_file_plugin_get_groups (ZakConfiFilePluginPrivate *priv, ZakConfiArena *arena, GNode *parentNode, gboolean with_keys)
+{
+	gchar **groups;
+	gsize lg;
+	guint g;
 
-							g_node_append_data (gNode, ck);
-						}
-				}
+	groups = g_key_file_get_groups (priv->kfile, &lg);
 
-			if (keys != NULL)
-				{
-					g_strfreev (keys);
-				}
+	for (g = 0; g < lg; g++)
+		{
+			g_node_append (parentNode, zak_confi_file_plugin_group_new (priv, arena, groups[g], with_keys));
 		}
 
 	if (groups != NULL)
@@ -315,6 +487,16 @@ zak_confi_file_plugin_get_children (ZakConfiPluggable *pluggable, GNode *parentN
 		}
 }
 
+static void
+zak_confi_file_plugin_get_children (ZakConfiPluggable *pluggable, GNode *parentNode)
+{
+	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (pluggable);
+
+	g_mutex_lock (&priv->mutex);
+	zak_confi_file_plugin_get_groups (priv, zak_confi_arena_get (parentNode), parentNode, TRUE);
+	g_mutex_unlock (&priv->mutex);
+}
+
 static GList
 *zak_confi_file_plugin_get_configs_list (ZakConfiPluggable *pluggable,
                                      const gchar *filter)
@@ -351,6 +533,51 @@ static gchar
 		}
 
 	ret = zak_confi_file_plugin_path_get_value_from_file (pluggable, path_);
+	g_free (path_);
+
+	return ret;
+}
+
+/* the keys are in memory, so it is a lookup for every path; the lock is
+ * taken once, so all the values come from the same version of the file */
+static GHashTable
+*zak_confi_file_plugin_paths_get_values (ZakConfiPluggable *pluggable, const gchar **paths)
+{
+	GHashTable *ret;
+	gchar *path_;
+	gchar *group;
+	gchar *key;
+	gchar *value;
+	guint i;
+
+	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (pluggable);
+
+	ret = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+	g_mutex_lock (&priv->mutex);
+	for (i = 0; paths != NULL && paths[i] != NULL; i++)
+		{
+			path_ = zak_confi_path_normalize (pluggable, paths[i]);
+			if (path_ == NULL)
+				{
+					continue;
+				}
+
+			group = NULL;
+			key = NULL;
+			if (zak_confi_file_plugin_path_get_group_and_key (path_, &group, &key))
+				{
+					value = g_key_file_get_value (priv->kfile, group, key, NULL);
+					if (value != NULL)
+						{
+							g_hash_table_replace (ret, g_strdup (paths[i]), value);
+						}
+					g_free (group);
+					g_free (key);
+				}
+			g_free (path_);
+		}
+	g_mutex_unlock (&priv->mutex);
 
 	return ret;
 }
@@ -358,14 +585,10 @@ static gchar
 static gboolean
 zak_confi_file_plugin_path_set_value (ZakConfiPluggable *pluggable, const gchar *path, const gchar *value)
 {
-	gboolean ret;
-
 	gchar *path_;
 	gchar *group;
 	gchar *key;
 
-	GError *error;
-
 	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (pluggable);
 
 	g_return_val_if_fail (value != NULL, FALSE);
@@ -378,46 +601,515 @@ zak_confi_file_plugin_path_set_value (ZakConfiPluggable *pluggable, const gchar
 
 	group = NULL;
 	key = NULL;
-	if (!zak_confi_file_plugin_path_get_group_and_key (path, &group, &key))
+	if (!zak_confi_file_plugin_path_get_group_and_key (path_, &group, &key))
 		{
+			g_free (path_);
 			return FALSE;
 		}
+	g_free (path_);
 
+	g_mutex_lock (&priv->mutex);
 	g_key_file_set_value (priv->kfile, group, key, value);
+	g_mutex_unlock (&priv->mutex);
 	g_free (group);
 	g_free (key);
 
+	return zak_confi_file_plugin_save (pluggable);
+}
+
+/* writes the file, unless inside a transaction; with SAVE_DELAY the file
+ * is only marked dirty and written by the worker thread */
+static gboolean
+zak_confi_file_plugin_save (ZakConfiPluggable *pluggable)
+{
+	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (priv->transaction != NULL)
+		{
+			return TRUE;
+		}
+
+	if (priv->save_thread != NULL)
+		{
+			g_mutex_lock (&priv->mutex);
+			if (!priv->dirty)
+				{
+					priv->dirty = TRUE;
+					priv->dirty_time = g_get_monotonic_time ();
+				}
+			g_cond_signal (&priv->cond);
+			g_mutex_unlock (&priv->mutex);
+
+			return TRUE;
+		}
+
+	return zak_confi_file_plugin_write (pluggable);
+}
+
+/* writes the current content; g_file_set_contents() writes a temporary
+ * file and renames it over the old one */
+static gboolean
+zak_confi_file_plugin_write (ZakConfiPluggable *pluggable)
+{
+	gboolean ret;
+	gchar *data;
+	gsize len;
+	GError *error;
+
+	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (pluggable);
+
+	g_mutex_lock (&priv->write_mutex);
+
+	g_mutex_lock (&priv->mutex);
+	if (priv->kfile == NULL)
+		{
+			g_mutex_unlock (&priv->mutex);
+			g_mutex_unlock (&priv->write_mutex);
+			return TRUE;
+		}
+	data = g_key_file_to_data (priv->kfile, &len, NULL);
+	priv->dirty = FALSE;
+	g_mutex_unlock (&priv->mutex);
+
 	error = NULL;
-	ret = g_key_file_save_to_file (priv->kfile, priv->cnc_string, &error);
-	if (error != NULL)
+	ret = g_file_set_contents (priv->filename, data, len, &error);
+	if (!ret || error != NULL)
 		{
+			g_warning ("Error on saving file: %s.",
+			           error != NULL && error->message != NULL ? error->message : "no details");
 			ret = FALSE;
 		}
+	if (error != NULL)
+		{
+			g_error_free (error);
+		}
+	g_free (data);
+
+	g_mutex_unlock (&priv->write_mutex);
 
 	return ret;
 }
 
+static gpointer
+zak_confi_file_plugin_save_thread (gpointer data)
+{
+	ZakConfiPluggable *pluggable = (ZakConfiPluggable *)data;
+	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (pluggable);
+
+	gint64 end_time;
+
+	g_mutex_lock (&priv->mutex);
+	while (!priv->save_quit)
+		{
+			if (!priv->dirty)
+				{
+					g_cond_wait (&priv->cond, &priv->mutex);
+					continue;
+				}
+
+			/* coalescing every change made in the window */
+			end_time = priv->dirty_time + (gint64)priv->save_delay * G_TIME_SPAN_MILLISECOND;
+			if (g_get_monotonic_time () < end_time)
+				{
+					g_cond_wait_until (&priv->cond, &priv->mutex, end_time);
+					continue;
+				}
+
+			g_mutex_unlock (&priv->mutex);
+			zak_confi_file_plugin_write (pluggable);
+			g_mutex_lock (&priv->mutex);
+		}
+	g_mutex_unlock (&priv->mutex);
+
+	return NULL;
+}
+
+/* adds to @paths every group/key of @a missing or with another value in @b */
+static void
+zak_confi_file_plugin_diff (GHashTable *paths, GKeyFile *a, GKeyFile *b)
+{
+	gchar **groups;
+	gchar **keys;
+	gchar *value_a;
+	gchar *value_b;
+	guint g;
+	guint k;
+
+	groups = g_key_file_get_groups (a, NULL);
+	for (g = 0; groups[g] != NULL; g++)
+		{
+			keys = g_key_file_get_keys (a, groups[g], NULL, NULL);
+			for (k = 0; keys != NULL && keys[k] != NULL; k++)
+				{
+					value_a = g_key_file_get_value (a, groups[g], keys[k], NULL);
+					value_b = g_key_file_get_value (b, groups[g], keys[k], NULL);
+					if (g_strcmp0 (value_a, value_b) != 0)
+						{
+							g_hash_table_add (paths, g_strdup_printf ("/%s/%s", groups[g], keys[k]));
+						}
+					g_free (value_a);
+					g_free (value_b);
+				}
+			g_strfreev (keys);
+		}
+	g_strfreev (groups);
+}
+
+/* reparses the file and swaps it in, reporting only the added, changed
+ * and removed keys; the changes not yet saved take precedence */
+static void
+zak_confi_file_plugin_reload (ZakConfiPluggable *pluggable)
+{
+	GKeyFile *kfile;
+	GHashTable *paths;
+	GHashTableIter iter;
+	gchar *path;
+	GError *error;
+
+	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (priv->transaction != NULL)
+		{
+			return;
+		}
+
+	kfile = g_key_file_new ();
+	error = NULL;
+	if (!g_key_file_load_from_file (kfile, priv->filename, G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS, &error)
+	    || error != NULL)
+		{
+			/* e.g. removed or not completely written: keeping the current content */
+			if (error != NULL)
+				{
+					g_error_free (error);
+				}
+			g_key_file_free (kfile);
+			return;
+		}
+
+	paths = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+	g_mutex_lock (&priv->mutex);
+	if (priv->dirty || priv->kfile == NULL)
+		{
+			g_mutex_unlock (&priv->mutex);
+			g_hash_table_destroy (paths);
+			g_key_file_free (kfile);
+			return;
+		}
+	zak_confi_file_plugin_diff (paths, priv->kfile, kfile);
+	zak_confi_file_plugin_diff (paths, kfile, priv->kfile);
+	if (g_hash_table_size (paths) > 0)
+		{
+			g_key_file_free (priv->kfile);
+			priv->kfile = kfile;
+			kfile = NULL;
+		}
+	g_mutex_unlock (&priv->mutex);
+
+	if (kfile != NULL)
+		{
+			g_key_file_free (kfile);
+		}
+
+	g_hash_table_iter_init (&iter, paths);
+	while (g_hash_table_iter_next (&iter, (gpointer *)&path, NULL))
+		{
+			zak_confi_pluggable_changed (pluggable, path);
+		}
+	g_hash_table_destroy (paths);
+}
+
+static void
+zak_confi_file_plugin_on_file_changed (GFileMonitor *monitor,
+                                       GFile *file,
+                                       GFile *other_file,
+                                       GFileMonitorEvent event_type,
+                                       gpointer user_data)
+{
+	/* g_file_set_contents() and most editors replace the file */
+	if (event_type == G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT
+	    || event_type == G_FILE_MONITOR_EVENT_CREATED)
+		{
+			zak_confi_file_plugin_reload ((ZakConfiPluggable *)user_data);
+		}
+}
+
+static gboolean
+zak_confi_file_plugin_flush (ZakConfiPluggable *pluggable)
+{
+	gboolean dirty;
+
+	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (pluggable);
+
+	g_mutex_lock (&priv->mutex);
+	dirty = priv->dirty;
+	g_mutex_unlock (&priv->mutex);
+
+	return (dirty ? zak_confi_file_plugin_write (pluggable) : TRUE);
+}
+
 GNode
 *zak_confi_file_plugin_get_tree (ZakConfiPluggable *pluggable)
 {
 	GNode *node;
+	ZakConfiArena *arena;
+	ZakConfiKey *ck;
 
 	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (pluggable);
 
-	ZakConfiKey *ck = g_new0 (ZakConfiKey, 1);
+	arena = zak_confi_arena_new ();
+	zak_confi_arena_set_intern_values (arena, priv->intern_values);
 
-	ck->path = "";
-	ck->description = "";
-	ck->key = g_strdup ("/");
-	ck->value = "";
+	ck = zak_confi_arena_key_new (arena);
+	ck->path = zak_confi_arena_intern (arena, "");
+	ck->description = zak_confi_arena_intern (arena, "");
+	ck->key = zak_confi_arena_intern (arena, "/");
+	ck->value = zak_confi_arena_intern (arena, "");
 
-	node = g_node_new (ck);
+	node = zak_confi_arena_new_tree (arena, ck);
 
 	zak_confi_file_plugin_get_children (pluggable, node);
 
 	return node;
 }
 
+/* @path without the empty segments: a group, or a group and its key */
+static gchar
+*zak_confi_file_plugin_path_strip (const gchar *path)
+{
+	gchar **tokens;
+	gchar *ret;
+	guint i;
+	guint j;
+
+	tokens = g_strsplit (path, "/", 0);
+	j = 0;
+	for (i = 0; tokens[i] != NULL; i++)
+		{
+			if (strcmp (g_strstrip (tokens[i]), "") == 0)
+				{
+					g_free (tokens[i]);
+				}
+			else
+				{
+					tokens[j++] = tokens[i];
+				}
+		}
+	tokens[j] = NULL;
+	ret = g_strjoinv ("/", tokens);
+	g_strfreev (tokens);
+
+	return ret;
+}
+
+static gint
+zak_confi_file_plugin_compare_paths (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	return strcmp ((const gchar *)a, (const gchar *)b);
+}
+
+static gboolean
+zak_confi_file_plugin_iter_add (gpointer key, gpointer value, gpointer data)
+{
+	g_ptr_array_add ((GPtrArray *)data, key);
+
+	return FALSE;
+}
+
+typedef struct
+	{
+		/* path => value */
+		GTree *keys;
+		GPtrArray *paths;
+		guint n;
+	} ZakConfiFileIter;
+
+/* the groups inside @prefix and their keys are read at once, under the
+ * lock, and sorted by path; a key hides a group with the same path, as
+ * in zak_confi_file_plugin_get_subtree() */
+static gpointer
+zak_confi_file_plugin_iter_new (ZakConfiPluggable *pluggable, const gchar *prefix)
+{
+	ZakConfiFileIter *iter;
+	gchar **groups;
+	gchar **keys;
+	gchar *group;
+	gchar *path;
+	gsize len;
+	guint g;
+	guint k;
+
+	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (prefix == NULL)
+		{
+			return NULL;
+		}
+
+	group = zak_confi_file_plugin_path_strip (prefix);
+	len = strlen (group);
+
+	iter = g_slice_new0 (ZakConfiFileIter);
+	iter->keys = g_tree_new_full (zak_confi_file_plugin_compare_paths, NULL, g_free, g_free);
+
+	g_mutex_lock (&priv->mutex);
+
+	groups = g_key_file_get_groups (priv->kfile, NULL);
+	for (g = 0; groups[g] != NULL; g++)
+		{
+			/* only @prefix and the groups inside it */
+			if (len > 0
+			    && (strncmp (groups[g], group, len) != 0
+			        || (groups[g][len] != '\0' && groups[g][len] != '/')))
+				{
+					continue;
+				}
+
+			/* the group itself, but not @prefix */
+			if (groups[g][len] != '\0')
+				{
+					path = g_strconcat ("/", groups[g], NULL);
+					if (g_tree_lookup (iter->keys, path) == NULL)
+						{
+							g_tree_insert (iter->keys, path, g_strdup (""));
+						}
+					else
+						{
+							g_free (path);
+						}
+				}
+
+			keys = g_key_file_get_keys (priv->kfile, groups[g], NULL, NULL);
+			for (k = 0; keys != NULL && keys[k] != NULL; k++)
+				{
+					g_tree_replace (iter->keys,
+					                g_strconcat ("/", groups[g], "/", keys[k], NULL),
+					                g_key_file_get_value (priv->kfile, groups[g], keys[k], NULL));
+				}
+			g_strfreev (keys);
+		}
+	g_strfreev (groups);
+
+	g_mutex_unlock (&priv->mutex);
+
+	g_free (group);
+
+	iter->paths = g_ptr_array_sized_new (g_tree_nnodes (iter->keys));
+	g_tree_foreach (iter->keys, zak_confi_file_plugin_iter_add, iter->paths);
+
+	return iter;
+}
+
+static gboolean
+zak_confi_file_plugin_iter_next (ZakConfiPluggable *pluggable, gpointer data, const gchar **path, const gchar **value)
+{
+	ZakConfiFileIter *iter = (ZakConfiFileIter *)data;
+
+	if (iter->n >= iter->paths->len)
+		{
+			return FALSE;
+		}
+
+	*path = (const gchar *)g_ptr_array_index (iter->paths, iter->n);
+	*value = (const gchar *)g_tree_lookup (iter->keys, *path);
+	iter->n++;
+
+	return TRUE;
+}
+
+static void
+zak_confi_file_plugin_iter_free (ZakConfiPluggable *pluggable, gpointer data)
+{
+	ZakConfiFileIter *iter = (ZakConfiFileIter *)data;
+
+	g_ptr_array_free (iter->paths, TRUE);
+	g_tree_unref (iter->keys);
+	g_slice_free (ZakConfiFileIter, iter);
+}
+
+/* the file has only two levels: the groups and their keys, so only the
+ * requested group is read; as in
+ * zak_confi_file_plugin_path_get_group_and_key(), a group can contain
+ * "/" and the key is after the last one */
+static GNode
+*zak_confi_file_plugin_get_subtree (ZakConfiPluggable *pluggable, const gchar *path, gint max_depth)
+{
+	GNode *node;
+	ZakConfiArena *arena;
+	ZakConfiKey *ck;
+	gchar *group;
+	gchar *key;
+
+	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (path == NULL)
+		{
+			return NULL;
+		}
+
+	group = zak_confi_file_plugin_path_strip (path);
+	key = strrchr (group, '/');
+	if (key != NULL)
+		{
+			*key++ = '\0';
+		}
+
+	node = NULL;
+
+	g_mutex_lock (&priv->mutex);
+
+	if (group[0] == '\0')
+		{
+			arena = zak_confi_arena_new ();
+			zak_confi_arena_set_intern_values (arena, priv->intern_values);
+
+			ck = zak_confi_arena_key_new (arena);
+			ck->path = zak_confi_arena_intern (arena, "");
+			ck->description = zak_confi_arena_intern (arena, "");
+			ck->key = zak_confi_arena_intern (arena, "/");
+			ck->value = zak_confi_arena_intern (arena, "");
+
+			node = zak_confi_arena_new_tree (arena, ck);
+			if (max_depth != 0)
+				{
+					zak_confi_file_plugin_get_groups (priv, arena, node, (max_depth < 0 || max_depth > 1));
+				}
+		}
+	else if (key != NULL
+	         && g_key_file_has_key (priv->kfile, group, key, NULL))
+		{
+			/* the key wins over a group with the same path, as when
+			 * reading the value */
+			arena = zak_confi_arena_new ();
+			zak_confi_arena_set_intern_values (arena, priv->intern_values);
+			node = zak_confi_arena_new_tree (arena, zak_confi_file_plugin_key_new (priv, arena, group, key));
+		}
+	else
+		{
+			if (key != NULL)
+				{
+					*(key - 1) = '/';
+				}
+			if (g_key_file_has_group (priv->kfile, group))
+				{
+					arena = zak_confi_arena_new ();
+					zak_confi_arena_set_intern_values (arena, priv->intern_values);
+					node = zak_confi_arena_new_tree (arena, zak_confi_file_plugin_key_new (priv, arena, group, NULL));
+					if (max_depth != 0)
+						{
+							zak_confi_file_plugin_get_keys (priv, arena, node, group);
+						}
+				}
+		}
+
+	g_mutex_unlock (&priv->mutex);
+
+	g_free (group);
+
+	return node;
+}
+
 static ZakConfiKey
 *zak_confi_file_plugin_add_key (ZakConfiPluggable *pluggable, const gchar *parent, const gchar *key, const gchar *value)
 {
@@ -525,12 +1217,20 @@ zak_confi_file_plugin_remove_path (ZakConfiPluggable *pluggable, const gchar *pa
 	if (zak_confi_file_plugin_path_get_group_and_key (path, &group, &key))
 		{
 			error = NULL;
+			g_mutex_lock (&priv->mutex);
 			ret = g_key_file_remove_key (priv->kfile, group, key, &error);
+			g_mutex_unlock (&priv->mutex);
 			if (error != NULL)
 				{
 					g_warning ("Error on removing key from file: %s.",
 					           error != NULL && error->message != NULL ? error->message : "no details");
 				}
+			else
+				{
+					ret = zak_confi_file_plugin_save (pluggable);
+				}
+			g_free (group);
+			g_free (key);
 		}
 	else
 		{
@@ -550,12 +1250,94 @@ zak_confi_file_plugin_remove (ZakConfiPluggable *pluggable)
 
 	ret = TRUE;
 
-	gfile = g_file_new_for_path (priv->cnc_string);
+	gfile = g_file_new_for_path (priv->filename);
 	if (gfile != NULL)
 		{
 			g_file_delete (gfile, NULL, NULL);
+			g_object_unref (gfile);
 		}
+
+	g_mutex_lock (&priv->mutex);
+	priv->dirty = FALSE;
 	g_key_file_unref (priv->kfile);
+	priv->kfile = NULL;
+	g_mutex_unlock (&priv->mutex);
+
+	return ret;
+}
+
+static gboolean
+zak_confi_file_plugin_begin (ZakConfiPluggable *pluggable)
+{
+	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (priv->transaction != NULL)
+		{
+			g_warning ("A transaction is already started.");
+			return FALSE;
+		}
+
+	priv->transaction = g_key_file_to_data (priv->kfile, NULL, NULL);
+
+	return (priv->transaction != NULL);
+}
+
+static gboolean
+zak_confi_file_plugin_commit (ZakConfiPluggable *pluggable)
+{
+	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (priv->transaction == NULL)
+		{
+			g_warning ("No transaction started.");
+			return FALSE;
+		}
+
+	g_free (priv->transaction);
+	priv->transaction = NULL;
+
+	return zak_confi_file_plugin_save (pluggable);
+}
+
+static gboolean
+zak_confi_file_plugin_rollback (ZakConfiPluggable *pluggable)
+{
+	gboolean ret;
+	GKeyFile *kfile;
+	GError *error;
+
+	ZakConfiFilePluginPrivate *priv = ZAK_CONFI_FILE_PLUGIN_GET_PRIVATE (pluggable);
+
+	if (priv->transaction == NULL)
+		{
+			g_warning ("No transaction started.");
+			return FALSE;
+		}
+
+	kfile = g_key_file_new ();
+	error = NULL;
+	ret = g_key_file_load_from_data (kfile, priv->transaction, -1, G_KEY_FILE_KEEP_COMMENTS | G_KEY_FILE_KEEP_TRANSLATIONS, &error);
+	if (ret && error == NULL)
+		{
+			g_mutex_lock (&priv->mutex);
+			g_key_file_free (priv->kfile);
+			priv->kfile = kfile;
+			g_mutex_unlock (&priv->mutex);
+		}
+	else
+		{
+			g_warning ("Error on restoring the file content: %s.",
+			           error != NULL && error->message != NULL ? error->message : "no details");
+			g_key_file_free (kfile);
+			ret = FALSE;
+		}
+	if (error != NULL)
+		{
+			g_error_free (error);
+		}
+
+	g_free (priv->transaction);
+	priv->transaction = NULL;
 
 	return ret;
 }
@@ -575,6 +1357,7 @@ zak_confi_file_plugin_class_init (ZakConfiFilePluginClass *klass)
 	g_object_class_override_property (object_class, PROP_NAME, "name");
 	g_object_class_override_property (object_class, PROP_DESCRIPTION, "description");
 	g_object_class_override_property (object_class, PROP_ROOT, "root");
+	g_object_class_override_property (object_class, PROP_INTERN_VALUES, "intern_values");
 }
 
 static void
@@ -585,11 +1368,20 @@ zak_confi_pluggable_iface_init (ZakConfiPluggableInterface *iface)
 	iface->path_get_value = zak_confi_file_plugin_path_get_value;
 	iface->path_set_value = zak_confi_file_plugin_path_set_value;
 	iface->get_tree = zak_confi_file_plugin_get_tree;
+	iface->get_subtree = zak_confi_file_plugin_get_subtree;
+	iface->iter_new = zak_confi_file_plugin_iter_new;
+	iface->iter_next = zak_confi_file_plugin_iter_next;
+	iface->iter_free = zak_confi_file_plugin_iter_free;
 	iface->add_key = zak_confi_file_plugin_add_key;
 	iface->key_set_key = zak_confi_file_plugin_key_set_key;
 	iface->path_get_confi_key = zak_confi_file_plugin_path_get_confi_key;
 	iface->remove_path = zak_confi_file_plugin_remove_path;
 	iface->remove = zak_confi_file_plugin_remove;
+	iface->paths_get_values = zak_confi_file_plugin_paths_get_values;
+	iface->begin = zak_confi_file_plugin_begin;
+	iface->commit = zak_confi_file_plugin_commit;
+	iface->rollback = zak_confi_file_plugin_rollback;
+	iface->flush = zak_confi_file_plugin_flush;
 }
 
 static void
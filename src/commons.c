@@ -23,8 +23,19 @@
 #include <config.h>
 #endif
 
+#include <string.h>
+
 #include <commons.h>
 
+struct _ZakConfiSnapshot
+	{
+		volatile gint ref_count;
+		gchar *root;
+
+		/* absolute path -> value; never modified after construction */
+		GHashTable *values;
+	};
+
 ZakConfiConfi
 *zak_confi_confi_copy (ZakConfiConfi *confi)
 {
@@ -60,13 +71,24 @@ ZakConfiKey
 	b->value = g_strdup (key->value);
 	b->description = g_strdup (key->description);
 	b->path = g_strdup (key->path);
+	b->arena = NULL;
 
 	return b;
 }
 
+/**
+ * zak_confi_key_free:
+ * @key: a #ZakConfiKey returned by a function or by zak_confi_key_copy().
+ *
+ * The keys of a tree belong to its arena and are freed with the tree,
+ * by zak_confi_free_tree(); copy one with zak_confi_key_copy() to keep it.
+ */
 void
 zak_confi_key_free (ZakConfiKey *key)
 {
+	g_return_if_fail (key != NULL);
+	g_return_if_fail (key->arena == NULL);
+
 	g_free (key->key);
 	g_free (key->value);
 	g_free (key->description);
@@ -75,3 +97,983 @@ zak_confi_key_free (ZakConfiKey *key)
 }
 
 G_DEFINE_BOXED_TYPE (ZakConfiKey, zak_confi_key, zak_confi_key_copy, zak_confi_key_free)
+
+/* the keys are allocated in blocks of this size */
+#define ZAK_CONFI_ARENA_BLOCK 256
+
+struct _ZakConfiArena
+	{
+		GStringChunk *strings;
+		GSList *blocks;
+		guint used;
+
+		gboolean intern_values;
+
+		/* the tree freeing the arena; every key points to the arena */
+		GNode *root;
+	};
+
+/**
+ * zak_confi_arena_new:
+ *
+ * Creates the memory for the keys, and their strings, of one tree. The
+ * plugins use it to build the trees returned by get_tree and
+ * get_subtree, so they are released at once by zak_confi_free_tree().
+ *
+ * Returns: a new #ZakConfiArena.
+ */
+ZakConfiArena
+*zak_confi_arena_new (void)
+{
+	ZakConfiArena *arena;
+
+	arena = g_slice_new (ZakConfiArena);
+	arena->strings = g_string_chunk_new (4096);
+	arena->blocks = NULL;
+	arena->used = ZAK_CONFI_ARENA_BLOCK;
+	arena->intern_values = FALSE;
+	arena->root = NULL;
+
+	return arena;
+}
+
+/**
+ * zak_confi_arena_free:
+ * @arena: a #ZakConfiArena.
+ *
+ * Frees @arena with every key and string allocated from it.
+ */
+void
+zak_confi_arena_free (ZakConfiArena *arena)
+{
+	g_return_if_fail (arena != NULL);
+
+	g_string_chunk_free (arena->strings);
+	g_slist_free_full (arena->blocks, g_free);
+	g_slice_free (ZakConfiArena, arena);
+}
+
+/**
+ * zak_confi_arena_key_new:
+ * @arena: a #ZakConfiArena.
+ *
+ * Returns: (transfer none): a zeroed #ZakConfiKey owned by @arena; its
+ * strings must come from @arena too.
+ */
+ZakConfiKey
+*zak_confi_arena_key_new (ZakConfiArena *arena)
+{
+	ZakConfiKey *ck;
+
+	g_return_val_if_fail (arena != NULL, NULL);
+
+	if (arena->used == ZAK_CONFI_ARENA_BLOCK)
+		{
+			arena->blocks = g_slist_prepend (arena->blocks, g_new0 (ZakConfiKey, ZAK_CONFI_ARENA_BLOCK));
+			arena->used = 0;
+		}
+
+	ck = (ZakConfiKey *)arena->blocks->data + arena->used++;
+	ck->arena = arena;
+
+	return ck;
+}
+
+/**
+ * zak_confi_arena_strdup:
+ * @arena: a #ZakConfiArena.
+ * @str: (nullable): the string to copy.
+ *
+ * Returns: (transfer none): a copy of @str owned by @arena, or NULL.
+ */
+gchar
+*zak_confi_arena_strdup (ZakConfiArena *arena, const gchar *str)
+{
+	g_return_val_if_fail (arena != NULL, NULL);
+
+	return (str != NULL ? g_string_chunk_insert (arena->strings, str) : NULL);
+}
+
+/**
+ * zak_confi_arena_take:
+ * @arena: a #ZakConfiArena.
+ * @str: (transfer full) (nullable): the string to move in @arena.
+ *
+ * As zak_confi_arena_strdup(), freeing @str.
+ *
+ * Returns: (transfer none): a copy of @str owned by @arena, or NULL.
+ */
+gchar
+*zak_confi_arena_take (ZakConfiArena *arena, gchar *str)
+{
+	gchar *ret;
+
+	ret = zak_confi_arena_strdup (arena, str);
+	g_free (str);
+
+	return ret;
+}
+
+/**
+ * zak_confi_arena_intern:
+ * @arena: a #ZakConfiArena.
+ * @str: (nullable): the string to intern.
+ *
+ * As zak_confi_arena_strdup(), but equal strings share the same copy:
+ * for the key names and the paths, repeated all over a tree. The
+ * returned string must not be modified.
+ *
+ * Returns: (transfer none): the copy of @str in @arena, or NULL.
+ */
+gchar
+*zak_confi_arena_intern (ZakConfiArena *arena, const gchar *str)
+{
+	g_return_val_if_fail (arena != NULL, NULL);
+
+	return (str != NULL ? g_string_chunk_insert_const (arena->strings, str) : NULL);
+}
+
+/**
+ * zak_confi_arena_take_intern:
+ * @arena: a #ZakConfiArena.
+ * @str: (transfer full) (nullable): the string to intern.
+ *
+ * As zak_confi_arena_intern(), freeing @str.
+ *
+ * Returns: (transfer none): the copy of @str in @arena, or NULL.
+ */
+gchar
+*zak_confi_arena_take_intern (ZakConfiArena *arena, gchar *str)
+{
+	gchar *ret;
+
+	ret = zak_confi_arena_intern (arena, str);
+	g_free (str);
+
+	return ret;
+}
+
+/**
+ * zak_confi_arena_set_intern_values:
+ * @arena: a #ZakConfiArena.
+ * @intern: whether zak_confi_arena_take_value() interns the strings.
+ *
+ */
+void
+zak_confi_arena_set_intern_values (ZakConfiArena *arena, gboolean intern)
+{
+	g_return_if_fail (arena != NULL);
+
+	arena->intern_values = intern;
+}
+
+/**
+ * zak_confi_arena_take_value:
+ * @arena: a #ZakConfiArena.
+ * @str: (transfer full) (nullable): a value or a description.
+ *
+ * Moves @str in @arena, interned if so set by
+ * zak_confi_arena_set_intern_values().
+ *
+ * Returns: (transfer none): the copy of @str in @arena, or NULL.
+ */
+gchar
+*zak_confi_arena_take_value (ZakConfiArena *arena, gchar *str)
+{
+	g_return_val_if_fail (arena != NULL, NULL);
+
+	return (arena->intern_values ? zak_confi_arena_take_intern (arena, str) : zak_confi_arena_take (arena, str));
+}
+
+/**
+ * zak_confi_arena_new_tree:
+ * @arena: (transfer full): a #ZakConfiArena.
+ * @ck: the root's key, from @arena.
+ *
+ * Returns: a new root #GNode that owns @arena.
+ */
+GNode
+*zak_confi_arena_new_tree (ZakConfiArena *arena, ZakConfiKey *ck)
+{
+	GNode *tree;
+
+	g_return_val_if_fail (arena != NULL, NULL);
+	g_return_val_if_fail (ck != NULL && ck->arena == arena, NULL);
+
+	tree = g_node_new (ck);
+	zak_confi_arena_set_tree (arena, tree);
+
+	return tree;
+}
+
+/**
+ * zak_confi_arena_get:
+ * @node: a node of a tree.
+ *
+ * Returns: (transfer none) (nullable): the arena holding the key of
+ * @node, if any.
+ */
+ZakConfiArena
+*zak_confi_arena_get (GNode *node)
+{
+	g_return_val_if_fail (node != NULL, NULL);
+
+	return (node->data != NULL ? ((ZakConfiKey *)node->data)->arena : NULL);
+}
+
+/**
+ * zak_confi_arena_steal:
+ * @tree: the root of a tree.
+ *
+ * Takes the arena away from @tree, e.g. to give it to a branch with
+ * zak_confi_arena_set_tree().
+ *
+ * Returns: (transfer full) (nullable): the arena owned by @tree, if any.
+ */
+ZakConfiArena
+*zak_confi_arena_steal (GNode *tree)
+{
+	ZakConfiArena *arena;
+
+	g_return_val_if_fail (tree != NULL, NULL);
+
+	arena = zak_confi_arena_get (tree);
+	if (arena == NULL || arena->root != tree)
+		{
+			return NULL;
+		}
+
+	arena->root = NULL;
+
+	return arena;
+}
+
+/**
+ * zak_confi_arena_set_tree:
+ * @arena: (transfer full): a #ZakConfiArena.
+ * @tree: the root of a tree, whose key is from @arena.
+ *
+ * Gives the ownership of @arena to @tree.
+ */
+void
+zak_confi_arena_set_tree (ZakConfiArena *arena, GNode *tree)
+{
+	g_return_if_fail (arena != NULL);
+	g_return_if_fail (tree != NULL && G_NODE_IS_ROOT (tree));
+	g_return_if_fail (zak_confi_arena_get (tree) == arena);
+
+	arena->root = tree;
+}
+
+static gboolean
+zak_confi_free_tree_key_func (GNode *node, gpointer data)
+{
+	ZakConfiKey *ck = (ZakConfiKey *)node->data;
+
+	if (ck != NULL)
+		{
+			g_free (ck->key);
+			g_free (ck->value);
+			g_free (ck->description);
+			g_free (ck->path);
+			g_free (ck);
+		}
+
+	return FALSE;
+}
+
+/**
+ * zak_confi_free_tree:
+ * @tree: (nullable): a tree returned by zak_confi_get_tree() or
+ * zak_confi_get_subtree().
+ *
+ * Frees @tree with all its keys. Trees built in a #ZakConfiArena are
+ * released at once; the others key by key.
+ *
+ * A branch unlinked from an arena tree only loses its nodes: its keys
+ * stay in the arena, freed with the tree it came from, so the branch
+ * must be freed first. Freeing an arena tree with g_node_destroy()
+ * leaks its keys.
+ */
+void
+zak_confi_free_tree (GNode *tree)
+{
+	ZakConfiArena *arena;
+
+	if (tree == NULL)
+		{
+			return;
+		}
+
+	g_return_if_fail (G_NODE_IS_ROOT (tree));
+
+	arena = zak_confi_arena_get (tree);
+	if (arena != NULL)
+		{
+			g_node_destroy (tree);
+			if (arena->root == tree)
+				{
+					zak_confi_arena_free (arena);
+				}
+		}
+	else
+		{
+			g_node_traverse (tree, G_PRE_ORDER, G_TRAVERSE_ALL, -1, zak_confi_free_tree_key_func, NULL);
+			g_node_destroy (tree);
+		}
+}
+
+static void
+zak_confi_snapshot_add_children (GHashTable *values, GNode *parentNode, const gchar *path)
+{
+	GNode *node;
+	gchar *path_;
+
+	for (node = parentNode->children; node != NULL; node = node->next)
+		{
+			ZakConfiKey *ck = (ZakConfiKey *)node->data;
+
+			path_ = g_strconcat (path, "/", ck->key, NULL);
+			g_hash_table_replace (values, path_, g_strdup (ck->value != NULL ? ck->value : ""));
+			if (node->children != NULL)
+				{
+					zak_confi_snapshot_add_children (values, node, path_);
+				}
+		}
+}
+
+/**
+ * zak_confi_snapshot_new_from_tree:
+ * @tree: the tree returned by zak_confi_get_tree().
+ * @root: (nullable): the root used to resolve relative paths.
+ *
+ * Copies every key of @tree into a flat path->value table. The returned
+ * snapshot is never modified, so its values can be read by any number of
+ * threads without locking; to share one, see zak_confi_snapshot_acquire().
+ *
+ * Returns: (transfer full): a new #ZakConfiSnapshot.
+ */
+ZakConfiSnapshot
+*zak_confi_snapshot_new_from_tree (GNode *tree, const gchar *root)
+{
+	ZakConfiSnapshot *snapshot;
+
+	snapshot = g_slice_new (ZakConfiSnapshot);
+	snapshot->ref_count = 1;
+	snapshot->root = g_strdup (root != NULL ? root : "/");
+	snapshot->values = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+	if (tree != NULL)
+		{
+			zak_confi_snapshot_add_children (snapshot->values, tree, "");
+		}
+
+	return snapshot;
+}
+
+/**
+ * zak_confi_snapshot_ref:
+ * @snapshot: a #ZakConfiSnapshot.
+ *
+ * Returns: @snapshot.
+ */
+ZakConfiSnapshot
+*zak_confi_snapshot_ref (ZakConfiSnapshot *snapshot)
+{
+	g_return_val_if_fail (snapshot != NULL, NULL);
+
+	g_atomic_int_inc (&snapshot->ref_count);
+
+	return snapshot;
+}
+
+/**
+ * zak_confi_snapshot_unref:
+ * @snapshot: a #ZakConfiSnapshot.
+ *
+ */
+void
+zak_confi_snapshot_unref (ZakConfiSnapshot *snapshot)
+{
+	g_return_if_fail (snapshot != NULL);
+
+	if (g_atomic_int_dec_and_test (&snapshot->ref_count))
+		{
+			g_hash_table_destroy (snapshot->values);
+			g_free (snapshot->root);
+			g_slice_free (ZakConfiSnapshot, snapshot);
+		}
+}
+
+/**
+ * zak_confi_snapshot_get_root:
+ * @snapshot: a #ZakConfiSnapshot.
+ *
+ * Returns: the root captured when the snapshot was taken.
+ */
+const gchar
+*zak_confi_snapshot_get_root (ZakConfiSnapshot *snapshot)
+{
+	g_return_val_if_fail (snapshot != NULL, NULL);
+
+	return snapshot->root;
+}
+
+/**
+ * zak_confi_snapshot_get_value:
+ * @snapshot: a #ZakConfiSnapshot.
+ * @path: the key's path, relative to the snapshot's root.
+ *
+ * Returns: (transfer none): the value, owned by @snapshot, or NULL if
+ * @path doesn't exist.
+ */
+const gchar
+*zak_confi_snapshot_get_value (ZakConfiSnapshot *snapshot,
+                               const gchar *path)
+{
+	GString *path_;
+	const gchar *ret;
+
+	g_return_val_if_fail (snapshot != NULL, NULL);
+
+	if (path == NULL)
+		{
+			return NULL;
+		}
+
+	/* same rules of zak_confi_path_normalize () */
+	path_ = g_string_new (path);
+	g_strstrip (path_->str);
+	g_string_set_size (path_, strlen (path_->str));
+	if (path_->len == 0
+	    || path_->str[path_->len - 1] == '/')
+		{
+			g_string_free (path_, TRUE);
+			return NULL;
+		}
+
+	while (path_->str[0] == '/')
+		{
+			g_string_erase (path_, 0, 1);
+		}
+	g_string_prepend (path_, snapshot->root);
+
+	ret = (const gchar *)g_hash_table_lookup (snapshot->values, path_->str);
+	g_string_free (path_, TRUE);
+
+	return ret;
+}
+
+/**
+ * zak_confi_snapshot_get_size:
+ * @snapshot: a #ZakConfiSnapshot.
+ *
+ * Returns: the number of keys in @snapshot.
+ */
+guint
+zak_confi_snapshot_get_size (ZakConfiSnapshot *snapshot)
+{
+	g_return_val_if_fail (snapshot != NULL, 0);
+
+	return g_hash_table_size (snapshot->values);
+}
+
+/* bit 0 of the shared pointer locks it, as a snapshot is at least
+ * pointer-aligned: the load and the ref of the published snapshot can't
+ * overlap its replacement, and the readers of different locations don't
+ * contend */
+#define ZAK_CONFI_SNAPSHOT_LOCK_BIT 0
+
+/**
+ * zak_confi_snapshot_acquire:
+ * @location: the shared pointer written with zak_confi_snapshot_exchange().
+ *
+ * Reads the snapshot stored in @location and takes a reference on it, as
+ * one step: the readers of a shared snapshot must use this function,
+ * because between a plain read of @location and zak_confi_snapshot_ref()
+ * the snapshot could be replaced and freed. The step holds a lock on
+ * @location alone, for the load and the ref; the values are then read
+ * without locking.
+ *
+ * Returns: (transfer full) (nullable): the current snapshot; the caller
+ * must unref it.
+ */
+ZakConfiSnapshot
+*zak_confi_snapshot_acquire (ZakConfiSnapshot **location)
+{
+	ZakConfiSnapshot *ret;
+
+	g_return_val_if_fail (location != NULL, NULL);
+
+	g_pointer_bit_lock (location, ZAK_CONFI_SNAPSHOT_LOCK_BIT);
+	ret = (ZakConfiSnapshot *)((gsize)g_atomic_pointer_get (location) & ~((gsize)1 << ZAK_CONFI_SNAPSHOT_LOCK_BIT));
+	if (ret != NULL)
+		{
+			zak_confi_snapshot_ref (ret);
+		}
+	g_pointer_bit_unlock (location, ZAK_CONFI_SNAPSHOT_LOCK_BIT);
+
+	return ret;
+}
+
+/**
+ * zak_confi_snapshot_exchange:
+ * @location: the shared pointer read by the other threads.
+ * @snapshot: (transfer full) (nullable): the new snapshot.
+ *
+ * Atomically replaces the snapshot stored in @location with @snapshot,
+ * under the lock of @location taken by zak_confi_snapshot_acquire();
+ * @location must be read only through these two functions. The readers
+ * that got the previous snapshot keep using it until they release it.
+ *
+ * Returns: (transfer full) (nullable): the previous snapshot; the caller
+ * must unref it.
+ */
+ZakConfiSnapshot
+*zak_confi_snapshot_exchange (ZakConfiSnapshot **location,
+                              ZakConfiSnapshot *snapshot)
+{
+	ZakConfiSnapshot *old;
+
+	g_return_val_if_fail (location != NULL, NULL);
+
+	g_pointer_bit_lock (location, ZAK_CONFI_SNAPSHOT_LOCK_BIT);
+	old = (ZakConfiSnapshot *)((gsize)g_atomic_pointer_get (location) & ~((gsize)1 << ZAK_CONFI_SNAPSHOT_LOCK_BIT));
+	/* still locked, until the unlock clears the bit */
+	g_atomic_pointer_set (location, (gpointer)((gsize)snapshot | ((gsize)1 << ZAK_CONFI_SNAPSHOT_LOCK_BIT)));
+	g_pointer_bit_unlock (location, ZAK_CONFI_SNAPSHOT_LOCK_BIT);
+
+	return old;
+}
+
+G_DEFINE_BOXED_TYPE (ZakConfiSnapshot, zak_confi_snapshot, zak_confi_snapshot_ref, zak_confi_snapshot_unref)
+
+typedef struct
+	{
+		gint id;
+		guint parent;
+		guint children;   /* index of the first child */
+		guint n_children;
+		guint key;        /* offsets in the string pool */
+		guint value;
+		guint description;
+	} ZakConfiTreeNode;
+
+struct _ZakConfiTree
+	{
+		volatile gint ref_count;
+
+		/* breadth first, so the children of a node are contiguous and
+		 * sorted by key */
+		ZakConfiTreeNode *nodes;
+		guint n_nodes;
+
+		/* every string, nul terminated */
+		gchar *pool;
+	};
+
+static guint
+zak_confi_tree_pool_add (GString *pool, const gchar *str)
+{
+	guint ret;
+
+	if (str == NULL)
+		{
+			return ZAK_CONFI_TREE_NONE;
+		}
+
+	ret = pool->len;
+	g_string_append_len (pool, str, strlen (str) + 1);
+
+	return ret;
+}
+
+static gint
+zak_confi_tree_compare_nodes (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	ZakConfiKey *ck_a = (ZakConfiKey *)(*(GNode **)a)->data;
+	ZakConfiKey *ck_b = (ZakConfiKey *)(*(GNode **)b)->data;
+
+	return g_strcmp0 (ck_a != NULL ? ck_a->key : NULL,
+	                  ck_b != NULL ? ck_b->key : NULL);
+}
+
+/**
+ * zak_confi_tree_new_from_tree:
+ * @tree: (nullable): the tree returned by zak_confi_get_tree() or
+ * zak_confi_get_subtree().
+ *
+ * Copies @tree in a single array of nodes, with the children of every
+ * node contiguous and sorted by key, and all the strings in one block.
+ * The paths aren't stored: zak_confi_tree_get_path() rebuilds them.
+ *
+ * Returns: (transfer full): a new #ZakConfiTree.
+ */
+ZakConfiTree
+*zak_confi_tree_new_from_tree (GNode *tree)
+{
+	ZakConfiTree *ctree;
+	GPtrArray *gnodes;
+	GString *pool;
+	GNode *gnode;
+	GNode *child;
+	ZakConfiKey *ck;
+	guint first;
+	guint i;
+	guint c;
+
+	ctree = g_slice_new (ZakConfiTree);
+	ctree->ref_count = 1;
+	ctree->n_nodes = (tree != NULL ? g_node_n_nodes (tree, G_TRAVERSE_ALL) : 1);
+	ctree->nodes = g_new (ZakConfiTreeNode, ctree->n_nodes);
+
+	pool = g_string_sized_new (ctree->n_nodes * 16);
+
+	if (tree == NULL)
+		{
+			ctree->nodes[0].id = 0;
+			ctree->nodes[0].parent = ZAK_CONFI_TREE_NONE;
+			ctree->nodes[0].children = 1;
+			ctree->nodes[0].n_children = 0;
+			ctree->nodes[0].key = ZAK_CONFI_TREE_NONE;
+			ctree->nodes[0].value = ZAK_CONFI_TREE_NONE;
+			ctree->nodes[0].description = ZAK_CONFI_TREE_NONE;
+
+			ctree->pool = g_string_free (pool, FALSE);
+			return ctree;
+		}
+
+	gnodes = g_ptr_array_sized_new (ctree->n_nodes);
+	g_ptr_array_add (gnodes, tree);
+	ctree->nodes[0].parent = ZAK_CONFI_TREE_NONE;
+
+	for (i = 0; i < gnodes->len; i++)
+		{
+			gnode = (GNode *)g_ptr_array_index (gnodes, i);
+			ck = (ZakConfiKey *)gnode->data;
+
+			ctree->nodes[i].id = (ck != NULL ? ck->id : 0);
+			ctree->nodes[i].key = zak_confi_tree_pool_add (pool, ck != NULL ? ck->key : NULL);
+			ctree->nodes[i].value = zak_confi_tree_pool_add (pool, ck != NULL ? ck->value : NULL);
+			ctree->nodes[i].description = zak_confi_tree_pool_add (pool, ck != NULL ? ck->description : NULL);
+
+			first = gnodes->len;
+			for (child = gnode->children; child != NULL; child = child->next)
+				{
+					g_ptr_array_add (gnodes, child);
+				}
+			g_qsort_with_data (gnodes->pdata + first, gnodes->len - first, sizeof (gpointer), zak_confi_tree_compare_nodes, NULL);
+
+			ctree->nodes[i].children = first;
+			ctree->nodes[i].n_children = gnodes->len - first;
+			for (c = first; c < gnodes->len; c++)
+				{
+					ctree->nodes[c].parent = i;
+				}
+		}
+
+	g_ptr_array_free (gnodes, TRUE);
+	ctree->pool = g_string_free (pool, FALSE);
+
+	return ctree;
+}
+
+/**
+ * zak_confi_tree_ref:
+ * @tree: a #ZakConfiTree.
+ *
+ * Returns: @tree.
+ */
+ZakConfiTree
+*zak_confi_tree_ref (ZakConfiTree *tree)
+{
+	g_return_val_if_fail (tree != NULL, NULL);
+
+	g_atomic_int_inc (&tree->ref_count);
+
+	return tree;
+}
+
+/**
+ * zak_confi_tree_unref:
+ * @tree: a #ZakConfiTree.
+ *
+ */
+void
+zak_confi_tree_unref (ZakConfiTree *tree)
+{
+	g_return_if_fail (tree != NULL);
+
+	if (g_atomic_int_dec_and_test (&tree->ref_count))
+		{
+			g_free (tree->nodes);
+			g_free (tree->pool);
+			g_slice_free (ZakConfiTree, tree);
+		}
+}
+
+/**
+ * zak_confi_tree_get_size:
+ * @tree: a #ZakConfiTree.
+ *
+ * Returns: the number of nodes in @tree, the top included.
+ */
+guint
+zak_confi_tree_get_size (ZakConfiTree *tree)
+{
+	g_return_val_if_fail (tree != NULL, 0);
+
+	return tree->n_nodes;
+}
+
+/**
+ * zak_confi_tree_get_parent:
+ * @tree: a #ZakConfiTree.
+ * @node: a node of @tree.
+ *
+ * Returns: the parent of @node, or #ZAK_CONFI_TREE_NONE for the top.
+ */
+guint
+zak_confi_tree_get_parent (ZakConfiTree *tree, guint node)
+{
+	g_return_val_if_fail (tree != NULL, ZAK_CONFI_TREE_NONE);
+	g_return_val_if_fail (node < tree->n_nodes, ZAK_CONFI_TREE_NONE);
+
+	return tree->nodes[node].parent;
+}
+
+/**
+ * zak_confi_tree_get_n_children:
+ * @tree: a #ZakConfiTree.
+ * @node: a node of @tree.
+ *
+ * Returns: the number of children of @node.
+ */
+guint
+zak_confi_tree_get_n_children (ZakConfiTree *tree, guint node)
+{
+	g_return_val_if_fail (tree != NULL, 0);
+	g_return_val_if_fail (node < tree->n_nodes, 0);
+
+	return tree->nodes[node].n_children;
+}
+
+/**
+ * zak_confi_tree_get_child:
+ * @tree: a #ZakConfiTree.
+ * @node: a node of @tree.
+ * @n: the position of the child, in key order.
+ *
+ * Returns: the @n-th child of @node, or #ZAK_CONFI_TREE_NONE.
+ */
+guint
+zak_confi_tree_get_child (ZakConfiTree *tree, guint node, guint n)
+{
+	g_return_val_if_fail (tree != NULL, ZAK_CONFI_TREE_NONE);
+	g_return_val_if_fail (node < tree->n_nodes, ZAK_CONFI_TREE_NONE);
+
+	if (n >= tree->nodes[node].n_children)
+		{
+			return ZAK_CONFI_TREE_NONE;
+		}
+
+	return tree->nodes[node].children + n;
+}
+
+/* binary search of the first @len chars of @key among the children of
+ * @node */
+static guint
+zak_confi_tree_lookup_child_len (ZakConfiTree *tree, guint node, const gchar *key, gsize len)
+{
+	const gchar *key_;
+	guint lo;
+	guint hi;
+	guint mid;
+	gint cmp;
+
+	lo = tree->nodes[node].children;
+	hi = lo + tree->nodes[node].n_children;
+	while (lo < hi)
+		{
+			mid = lo + (hi - lo) / 2;
+			key_ = (tree->nodes[mid].key != ZAK_CONFI_TREE_NONE ? tree->pool + tree->nodes[mid].key : "");
+
+			cmp = strncmp (key_, key, len);
+			if (cmp == 0 && key_[len] != '\0')
+				{
+					cmp = 1;
+				}
+
+			if (cmp == 0)
+				{
+					return mid;
+				}
+			else if (cmp < 0)
+				{
+					lo = mid + 1;
+				}
+			else
+				{
+					hi = mid;
+				}
+		}
+
+	return ZAK_CONFI_TREE_NONE;
+}
+
+/**
+ * zak_confi_tree_lookup_child:
+ * @tree: a #ZakConfiTree.
+ * @node: a node of @tree.
+ * @key: the key of the child.
+ *
+ * Returns: the child of @node named @key, or #ZAK_CONFI_TREE_NONE.
+ */
+guint
+zak_confi_tree_lookup_child (ZakConfiTree *tree,
+                             guint node,
+                             const gchar *key)
+{
+	g_return_val_if_fail (tree != NULL, ZAK_CONFI_TREE_NONE);
+	g_return_val_if_fail (node < tree->n_nodes, ZAK_CONFI_TREE_NONE);
+	g_return_val_if_fail (key != NULL, ZAK_CONFI_TREE_NONE);
+
+	return zak_confi_tree_lookup_child_len (tree, node, key, strlen (key));
+}
+
+/**
+ * zak_confi_tree_lookup:
+ * @tree: a #ZakConfiTree.
+ * @path: the path of the node, relative to the top of @tree.
+ *
+ * Returns: the node at @path, or #ZAK_CONFI_TREE_NONE.
+ */
+guint
+zak_confi_tree_lookup (ZakConfiTree *tree, const gchar *path)
+{
+	const gchar *end;
+	guint node;
+
+	g_return_val_if_fail (tree != NULL, ZAK_CONFI_TREE_NONE);
+
+	if (path == NULL)
+		{
+			return ZAK_CONFI_TREE_NONE;
+		}
+
+	node = ZAK_CONFI_TREE_TOP;
+	while (node != ZAK_CONFI_TREE_NONE)
+		{
+			while (*path == '/')
+				{
+					path++;
+				}
+			if (*path == '\0')
+				{
+					break;
+				}
+
+			end = strchr (path, '/');
+			if (end == NULL)
+				{
+					end = path + strlen (path);
+				}
+
+			node = zak_confi_tree_lookup_child_len (tree, node, path, end - path);
+			path = end;
+		}
+
+	return node;
+}
+
+/**
+ * zak_confi_tree_get_id:
+ * @tree: a #ZakConfiTree.
+ * @node: a node of @tree.
+ *
+ * Returns: the backend's id of @node.
+ */
+gint
+zak_confi_tree_get_id (ZakConfiTree *tree, guint node)
+{
+	g_return_val_if_fail (tree != NULL, 0);
+	g_return_val_if_fail (node < tree->n_nodes, 0);
+
+	return tree->nodes[node].id;
+}
+
+/**
+ * zak_confi_tree_get_key:
+ * @tree: a #ZakConfiTree.
+ * @node: a node of @tree.
+ *
+ * Returns: (transfer none): the key of @node, owned by @tree.
+ */
+const gchar
+*zak_confi_tree_get_key (ZakConfiTree *tree, guint node)
+{
+	g_return_val_if_fail (tree != NULL, NULL);
+	g_return_val_if_fail (node < tree->n_nodes, NULL);
+
+	return (tree->nodes[node].key != ZAK_CONFI_TREE_NONE ? tree->pool + tree->nodes[node].key : NULL);
+}
+
+/**
+ * zak_confi_tree_get_value:
+ * @tree: a #ZakConfiTree.
+ * @node: a node of @tree.
+ *
+ * Returns: (transfer none): the value of @node, owned by @tree.
+ */
+const gchar
+*zak_confi_tree_get_value (ZakConfiTree *tree, guint node)
+{
+	g_return_val_if_fail (tree != NULL, NULL);
+	g_return_val_if_fail (node < tree->n_nodes, NULL);
+
+	return (tree->nodes[node].value != ZAK_CONFI_TREE_NONE ? tree->pool + tree->nodes[node].value : NULL);
+}
+
+/**
+ * zak_confi_tree_get_description:
+ * @tree: a #ZakConfiTree.
+ * @node: a node of @tree.
+ *
+ * Returns: (transfer none): the description of @node, owned by @tree.
+ */
+const gchar
+*zak_confi_tree_get_description (ZakConfiTree *tree, guint node)
+{
+	g_return_val_if_fail (tree != NULL, NULL);
+	g_return_val_if_fail (node < tree->n_nodes, NULL);
+
+	return (tree->nodes[node].description != ZAK_CONFI_TREE_NONE ? tree->pool + tree->nodes[node].description : NULL);
+}
+
+/**
+ * zak_confi_tree_get_path:
+ * @tree: a #ZakConfiTree.
+ * @node: a node of @tree.
+ *
+ * Returns: (transfer full): the path of @node relative to the top of
+ * @tree, as "/key/key"; an empty string for the top.
+ */
+gchar
+*zak_confi_tree_get_path (ZakConfiTree *tree, guint node)
+{
+	GString *path;
+
+	g_return_val_if_fail (tree != NULL, NULL);
+	g_return_val_if_fail (node < tree->n_nodes, NULL);
+
+	path = g_string_new ("");
+	for (; node != ZAK_CONFI_TREE_TOP; node = tree->nodes[node].parent)
+		{
+			g_string_prepend (path, zak_confi_tree_get_key (tree, node) != NULL ? zak_confi_tree_get_key (tree, node) : "");
+			g_string_prepend_c (path, '/');
+		}
+
+	return g_string_free (path, FALSE);
+}
+
+G_DEFINE_BOXED_TYPE (ZakConfiTree, zak_confi_tree, zak_confi_tree_ref, zak_confi_tree_unref)
@@ -43,6 +43,8 @@ void zak_confi_confi_free (ZakConfiConfi *confi);
 
 GType zak_confi_key_get_type ();
 
+typedef struct _ZakConfiArena ZakConfiArena;
+
 typedef struct _ZakConfiKey ZakConfiKey;
 struct _ZakConfiKey
 	{
@@ -53,11 +55,85 @@ struct _ZakConfiKey
 		gchar *value;
 		gchar *description;
 		gchar *path;
+
+		/*< private >*/
+		ZakConfiArena *arena;
 	};
 
 ZakConfiKey *zak_confi_key_copy (ZakConfiKey *key);
 void zak_confi_key_free (ZakConfiKey *key);
 
+ZakConfiArena *zak_confi_arena_new (void);
+void zak_confi_arena_free (ZakConfiArena *arena);
+
+ZakConfiKey *zak_confi_arena_key_new (ZakConfiArena *arena);
+gchar *zak_confi_arena_strdup (ZakConfiArena *arena, const gchar *str);
+gchar *zak_confi_arena_take (ZakConfiArena *arena, gchar *str);
+gchar *zak_confi_arena_intern (ZakConfiArena *arena, const gchar *str);
+gchar *zak_confi_arena_take_intern (ZakConfiArena *arena, gchar *str);
+
+void zak_confi_arena_set_intern_values (ZakConfiArena *arena, gboolean intern);
+gchar *zak_confi_arena_take_value (ZakConfiArena *arena, gchar *str);
+
+GNode *zak_confi_arena_new_tree (ZakConfiArena *arena, ZakConfiKey *ck);
+ZakConfiArena *zak_confi_arena_get (GNode *node);
+ZakConfiArena *zak_confi_arena_steal (GNode *tree);
+void zak_confi_arena_set_tree (ZakConfiArena *arena, GNode *tree);
+
+void zak_confi_free_tree (GNode *tree);
+
+#define ZAK_CONFI_TYPE_SNAPSHOT (zak_confi_snapshot_get_type ())
+
+GType zak_confi_snapshot_get_type ();
+
+typedef struct _ZakConfiSnapshot ZakConfiSnapshot;
+
+ZakConfiSnapshot *zak_confi_snapshot_new_from_tree (GNode *tree, const gchar *root);
+
+ZakConfiSnapshot *zak_confi_snapshot_ref (ZakConfiSnapshot *snapshot);
+void zak_confi_snapshot_unref (ZakConfiSnapshot *snapshot);
+
+const gchar *zak_confi_snapshot_get_root (ZakConfiSnapshot *snapshot);
+const gchar *zak_confi_snapshot_get_value (ZakConfiSnapshot *snapshot,
+                                           const gchar *path);
+guint zak_confi_snapshot_get_size (ZakConfiSnapshot *snapshot);
+
+ZakConfiSnapshot *zak_confi_snapshot_acquire (ZakConfiSnapshot **location);
+ZakConfiSnapshot *zak_confi_snapshot_exchange (ZakConfiSnapshot **location,
+                                               ZakConfiSnapshot *snapshot);
+
+#define ZAK_CONFI_TYPE_TREE (zak_confi_tree_get_type ())
+
+GType zak_confi_tree_get_type ();
+
+typedef struct _ZakConfiTree ZakConfiTree;
+
+/* the nodes of a #ZakConfiTree are addressed by index; the top is
+ * always 0 */
+#define ZAK_CONFI_TREE_TOP 0
+#define ZAK_CONFI_TREE_NONE G_MAXUINT
+
+ZakConfiTree *zak_confi_tree_new_from_tree (GNode *tree);
+
+ZakConfiTree *zak_confi_tree_ref (ZakConfiTree *tree);
+void zak_confi_tree_unref (ZakConfiTree *tree);
+
+guint zak_confi_tree_get_size (ZakConfiTree *tree);
+
+guint zak_confi_tree_get_parent (ZakConfiTree *tree, guint node);
+guint zak_confi_tree_get_n_children (ZakConfiTree *tree, guint node);
+guint zak_confi_tree_get_child (ZakConfiTree *tree, guint node, guint n);
+guint zak_confi_tree_lookup_child (ZakConfiTree *tree,
+                                   guint node,
+                                   const gchar *key);
+guint zak_confi_tree_lookup (ZakConfiTree *tree, const gchar *path);
+
+gint zak_confi_tree_get_id (ZakConfiTree *tree, guint node);
+const gchar *zak_confi_tree_get_key (ZakConfiTree *tree, guint node);
+const gchar *zak_confi_tree_get_value (ZakConfiTree *tree, guint node);
+const gchar *zak_confi_tree_get_description (ZakConfiTree *tree, guint node);
+gchar *zak_confi_tree_get_path (ZakConfiTree *tree, guint node);
+
 
 G_END_DECLS
 
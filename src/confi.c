@@ -50,8 +50,138 @@ static void zak_confi_get_property (GObject *object,
 
 static ZakConfiPluggable *zak_confi_get_confi_pluggable_from_cnc_string (const gchar *cnc_string);
 
+/* the types a cached value can be parsed to by the typed getters */
+typedef enum
+	{
+		ZAK_CONFI_PARSED_INT = 1 << 0,
+		ZAK_CONFI_PARSED_BOOLEAN = 1 << 1,
+		ZAK_CONFI_PARSED_DOUBLE = 1 << 2,
+		ZAK_CONFI_PARSED_STRV = 1 << 3
+	} ZakConfiParsedType;
+
+typedef struct
+	{
+		gint v_int;
+		gboolean v_boolean;
+		gdouble v_double;
+		gchar **v_strv;
+	} ZakConfiParsedValue;
+
+typedef struct
+	{
+		gchar *path;
+		gchar *value;
+		GList *link;
+
+		/* the types already parsed, and the ones @value is valid for */
+		guint parsed;
+		guint valid;
+		ZakConfiParsedValue parsed_value;
+	} ZakConfiCacheEntry;
+
+static void zak_confi_cache_entry_free (gpointer data);
+static gchar *zak_confi_cache_get (ZakConfi *confi, const gchar *path);
+static gchar *zak_confi_cache_lookup (ZakConfi *confi, const gchar *path);
+static gchar *zak_confi_cache_lookup_full (ZakConfi *confi, const gchar *path, gboolean quiet);
+static gboolean zak_confi_cache_lookup_parsed (ZakConfi *confi, const gchar *path, ZakConfiParsedType type, ZakConfiParsedValue *parsed);
+static void zak_confi_cache_insert (ZakConfi *confi, const gchar *path, const gchar *value);
+static void zak_confi_cache_remove_prefix (ZakConfi *confi, const gchar *prefix);
+static void zak_confi_cache_remove_normalized (ZakConfi *confi, const gchar *prefix);
+
+static gboolean zak_confi_absent_contains (ZakConfi *confi, const gchar *path);
+static void zak_confi_absent_insert (ZakConfi *confi, gchar *path, gboolean branch);
+static void zak_confi_absent_remove_ancestors (ZakConfi *confi, const gchar *path);
+static void zak_confi_absent_clear (ZakConfi *confi);
+
+static gchar *zak_confi_path_normalize_prefix (ZakConfi *confi, const gchar *path);
+static gboolean zak_confi_path_is_below (const gchar *path, const gchar *prefix);
+static void zak_confi_changed (ZakConfi *confi, const gchar *path);
+static void zak_confi_path_set_value_done (ZakConfi *confi, const gchar *path);
+static void zak_confi_on_pluggable_changed (ZakConfiPluggable *pluggable, const gchar *path, gpointer user_data);
+static void zak_confi_emit_changed (ZakConfi *confi, const gchar *path);
+
+static GPtrArray *zak_confi_paths_get_cached (ZakConfi *confi, const gchar **paths, GHashTable *ret);
+static void zak_confi_paths_add_values (ZakConfi *confi, GHashTable *ret, GHashTable *values);
+
+
+/* the asynchronous operations run the synchronous ones on a bounded pool
+ * of worker threads, or the plugin's own asynchronous functions in the
+ * caller's context, one operation per ZakConfi at a time: the others wait
+ * in the instance's queue, not on a pool thread */
+#define ZAK_CONFI_ASYNC_MAX_THREADS 4
+
+static GThreadPool *async_pool = NULL;
+
+/* in a worker thread, the main context of the operation running: the
+ * changes are notified there */
+static GPrivate async_context = G_PRIVATE_INIT (NULL);
+
+typedef enum
+	{
+		ZAK_CONFI_ASYNC_NEW,
+		ZAK_CONFI_ASYNC_GET_CONFIGS_LIST,
+		ZAK_CONFI_ASYNC_GET_TREE,
+		ZAK_CONFI_ASYNC_SNAPSHOT_NEW,
+		ZAK_CONFI_ASYNC_ADD_KEY,
+		ZAK_CONFI_ASYNC_KEY_SET_KEY,
+		ZAK_CONFI_ASYNC_REMOVE_PATH,
+		ZAK_CONFI_ASYNC_PATH_GET_VALUE,
+		ZAK_CONFI_ASYNC_PATHS_GET_VALUES,
+		ZAK_CONFI_ASYNC_PATH_SET_VALUE,
+		ZAK_CONFI_ASYNC_PATH_GET_CONFI_KEY,
+		ZAK_CONFI_ASYNC_BEGIN,
+		ZAK_CONFI_ASYNC_COMMIT,
+		ZAK_CONFI_ASYNC_ROLLBACK,
+		ZAK_CONFI_ASYNC_FLUSH,
+		ZAK_CONFI_ASYNC_REMOVE
+	} ZakConfiAsyncOp;
+
+typedef struct
+	{
+		ZakConfiAsyncOp op;
+		gchar *path;
+		gchar *key;
+		gchar *value;
+		gchar **paths;
+		ZakConfiKey *ck;
+		GHashTable *values;
+
+		/* run by the plugin's own asynchronous function */
+		gboolean native;
+	} ZakConfiAsyncData;
+
+static GTask *zak_confi_async_new (gpointer source_object,
+                                   ZakConfiAsyncOp op,
+                                   GCancellable *cancellable,
+                                   GAsyncReadyCallback callback,
+                                   gpointer user_data,
+                                   gpointer source_tag);
+static void zak_confi_async_run (GTask *task);
+static void zak_confi_async_done (GTask *task);
+static gboolean zak_confi_async_start_native (gpointer user_data);
+static void zak_confi_async_worker (gpointer data, gpointer user_data);
+static void zak_confi_async_dispatch (GTask *task, ZakConfi *confi, ZakConfiAsyncData *adata);
+static void zak_confi_async_data_free (gpointer data);
+static void zak_confi_async_free_tree (gpointer data);
+
 #define ZAK_CONFI_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE ((obj), ZAK_TYPE_CONFI, ZakConfiPrivate))
 
+enum
+{
+	SIGNAL_CHANGED,
+	SIGNAL_LAST
+};
+
+static guint zak_confi_signals[SIGNAL_LAST] = { 0 };
+
+typedef struct
+	{
+		gchar *prefix;
+		ZakConfiWatchFunc func;
+		gpointer user_data;
+		GDestroyNotify notify;
+	} ZakConfiWatch;
+
 typedef struct _ZakConfiPrivate ZakConfiPrivate;
 struct _ZakConfiPrivate
 	{
@@ -60,10 +190,36 @@ struct _ZakConfiPrivate
 		gchar *name;
 		gchar *description;
 		gchar *root;
+
+		/* read-through values cache, keyed by normalized path;
+		 * cache_lock guards it and the counters */
+		GMutex cache_lock;
 		GHashTable *values;
+		GQueue lru;
+		guint cache_size;
+		guint cache_hits;
+		guint cache_misses;
+
+		/* negative cache: normalized paths known to be missing; the
+		 * branches, reported by the plugin, cover also the paths below
+		 * them; each set bounded to cache_size, oldest out */
+		GHashTable *absent;
+		GQueue absent_fifo;
+		GHashTable *absent_branches;
+		GQueue absent_branches_fifo;
 
 		gchar chrquot;
 
+		/* the asynchronous operations waiting for the running one;
+		 * lock guards them */
+		GMutex lock;
+		GQueue async_pending;
+		gboolean async_running;
+
+		/* incremented when the root or the keys structure changes, to
+		 * invalidate the compiled path handles */
+		gint serial;
+
 		ZakConfiPluggable *pluggable;
 	};
 
@@ -78,6 +234,29 @@ zak_confi_class_init (ZakConfiClass *klass)
 
 	object_class->set_property = zak_confi_set_property;
 	object_class->get_property = zak_confi_get_property;
+
+	/**
+	 * ZakConfi::changed:
+	 * @confi: the #ZakConfi object.
+	 * @path: the normalized path (with root) that changed, together
+	 * with every key below it.
+	 *
+	 * Emitted after every write made through @confi and for every change
+	 * reported by the plugin, in the thread that made the change; for the
+	 * asynchronous operations, in the thread-default main context of
+	 * their caller. The signal detail is @path, so "changed::/folder/key1"
+	 * is emitted only for exactly that path; use zak_confi_watch() to
+	 * follow a subtree.
+	 */
+	zak_confi_signals[SIGNAL_CHANGED] = g_signal_new ("changed",
+	                                                  G_TYPE_FROM_CLASS (object_class),
+	                                                  G_SIGNAL_RUN_LAST | G_SIGNAL_DETAILED,
+	                                                  G_STRUCT_OFFSET (ZakConfiClass, changed),
+	                                                  NULL,
+	                                                  NULL,
+	                                                  g_cclosure_marshal_VOID__STRING,
+	                                                  G_TYPE_NONE,
+	                                                  1, G_TYPE_STRING);
 }
 
 static void
@@ -86,14 +265,99 @@ zak_confi_init (ZakConfi *confi)
 	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
 
 	priv->pluggable = NULL;
+
+	g_mutex_init (&priv->lock);
+	g_queue_init (&priv->async_pending);
+	priv->async_running = FALSE;
+	g_mutex_init (&priv->cache_lock);
+	priv->values = NULL;
+	g_queue_init (&priv->lru);
+	priv->cache_size = 0;
+	priv->cache_hits = 0;
+	priv->cache_misses = 0;
+	priv->absent = NULL;
+	g_queue_init (&priv->absent_fifo);
+	priv->absent_branches = NULL;
+	g_queue_init (&priv->absent_branches_fifo);
+	priv->serial = 0;
+}
+
+/* process-wide registry of the plugins of the default PeasEngine, keyed
+ * by uri scheme (the module name); it is rebuilt only when the engine's
+ * plugin list changes (e.g. a search path is added) */
+static GMutex registry_mutex;
+static GHashTable *registry = NULL;
+static gint registry_valid = FALSE;
+
+static void
+zak_confi_registry_on_plugin_list_changed (GObject *object,
+                                           GParamSpec *pspec,
+                                           gpointer user_data)
+{
+	/* not locking: it's emitted also from inside zak_confi_registry_lookup () */
+	g_atomic_int_set (&registry_valid, FALSE);
+}
+
+/* returns the #PeasPluginInfo for the scheme of @cnc_string; must be
+ * called with registry_mutex locked */
+static PeasPluginInfo
+*zak_confi_registry_lookup (PeasEngine *peas_engine, const gchar *cnc_string)
+{
+	const GList *lst_plugins;
+	const gchar *sep;
+	gchar *scheme;
+	PeasPluginInfo *ppinfo;
+
+	if (registry == NULL)
+		{
+			registry = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+			peas_engine_add_search_path (peas_engine, PLUGINSDIR, NULL);
+			g_signal_connect (peas_engine, "notify::plugin-list",
+			                  G_CALLBACK (zak_confi_registry_on_plugin_list_changed), NULL);
+		}
+
+	if (!g_atomic_int_get (&registry_valid))
+		{
+			g_atomic_int_set (&registry_valid, TRUE);
+			g_hash_table_remove_all (registry);
+
+			lst_plugins = peas_engine_get_plugin_list (peas_engine);
+			while (lst_plugins)
+				{
+					ppinfo = (PeasPluginInfo *)lst_plugins->data;
+
+					/* the first plugin found wins, as the previous linear scan */
+					if (!g_hash_table_contains (registry, peas_plugin_info_get_module_name (ppinfo)))
+						{
+							g_hash_table_insert (registry,
+							                     g_strdup (peas_plugin_info_get_module_name (ppinfo)),
+							                     ppinfo);
+						}
+
+					lst_plugins = g_list_next (lst_plugins);
+				}
+		}
+
+	sep = strstr (cnc_string, "://");
+	if (sep == NULL)
+		{
+			return NULL;
+		}
+
+	scheme = g_strndup (cnc_string, sep - cnc_string);
+	ppinfo = (PeasPluginInfo *)g_hash_table_lookup (registry, scheme);
+	g_free (scheme);
+
+	return ppinfo;
 }
 
 static ZakConfiPluggable
 *zak_confi_get_confi_pluggable_from_cnc_string (const gchar *cnc_string)
 {
 	ZakConfiPluggable *pluggable;
-
-	const GList *lst_plugins;
+	PeasPluginInfo *ppinfo;
+	gboolean loaded;
 
 	pluggable = NULL;
 
@@ -105,34 +369,26 @@ static ZakConfiPluggable
 			return NULL;
 		}
 
-	peas_engine_add_search_path (peas_engine, PLUGINSDIR, NULL);
+	g_mutex_lock (&registry_mutex);
 
-	lst_plugins = peas_engine_get_plugin_list (peas_engine);
-	while (lst_plugins)
+	ppinfo = zak_confi_registry_lookup (peas_engine, cnc_string);
+	if (ppinfo != NULL)
 		{
-			PeasPluginInfo *ppinfo;
-			gchar *uri;
-
-			ppinfo = (PeasPluginInfo *)lst_plugins->data;
-
-			uri = g_strdup_printf ("%s://", peas_plugin_info_get_module_name (ppinfo));
-			if (g_str_has_prefix (cnc_string, uri))
+			/* the module is loaded only the first time */
+			loaded = peas_plugin_info_is_loaded (ppinfo)
+			         || peas_engine_load_plugin (peas_engine, ppinfo);
+			if (loaded)
 				{
-					if (peas_engine_load_plugin (peas_engine, ppinfo))
-						{
-							PeasExtension *ext;
-							ext = peas_engine_create_extension (peas_engine, ppinfo, ZAK_CONFI_TYPE_PLUGGABLE,
-							                                    "cnc_string", cnc_string + strlen (uri),
-							                                    NULL);
-							pluggable = (ZakConfiPluggable *)ext;
-							break;
-						}
+					PeasExtension *ext;
+					ext = peas_engine_create_extension (peas_engine, ppinfo, ZAK_CONFI_TYPE_PLUGGABLE,
+					                                    "cnc_string", strstr (cnc_string, "://") + 3,
+					                                    NULL);
+					pluggable = (ZakConfiPluggable *)ext;
 				}
-			g_free (uri);
-
-			lst_plugins = g_list_next (lst_plugins);
 		}
 
+	g_mutex_unlock (&registry_mutex);
+
 	if (pluggable == NULL)
 		{
 			g_warning ("No plugin found for connection string \"%s\".", cnc_string);
@@ -145,6 +401,12 @@ static ZakConfiPluggable
  * zak_confi_new:
  * @cnc_string: the connection string.
  *
+ * A #ZakConfi isn't thread-safe, as the plugins aren't: its functions
+ * must be called by one thread at a time, and not while one of its
+ * asynchronous operations is pending. The asynchronous operations on the
+ * same #ZakConfi, those the plugin runs by itself included, are run one
+ * at a time, in the order they're started.
+ *
  * Returns: (transfer none): the newly created #ZakConfi object, or NULL if it fails.
  */
 ZakConfi
@@ -164,6 +426,9 @@ ZakConfi
 			confi = ZAK_CONFI (g_object_new (zak_confi_get_type (), NULL));
 			priv = ZAK_CONFI_GET_PRIVATE (confi);
 			priv->pluggable = pluggable;
+
+			g_signal_connect (pluggable, "changed",
+			                  G_CALLBACK (zak_confi_on_pluggable_changed), confi);
 		}
 
 	return confi;
@@ -212,6 +477,7 @@ GList
 	if (pluggable != NULL)
 		{
 			lst = zak_confi_pluggable_get_configs_list (pluggable, filter);
+			g_object_unref (pluggable);
 		}
 
 	return lst;
@@ -221,7 +487,7 @@ GList
  * zak_confi_get_tree:
  * @confi: a #ZakConfi object.
  *
- * Returns: a #GNode.
+ * Returns: a #GNode, to free with zak_confi_free_tree().
  */
 GNode
 *zak_confi_get_tree (ZakConfi *confi)
@@ -238,248 +504,478 @@ GNode
 		}
 }
 
-/**
- * zak_confi_normalize_set_root:
- * @confi: a #ZakConfi object.
- * @root: the root.
- *
- * Returns: a correct value for root property.
- */
-gchar
-*zak_confi_normalize_root (const gchar *root)
+/* frees the nodes of @node deeper than @depth levels; with @arena the
+ * keys are left to the arena */
+static void
+zak_confi_tree_prune (GNode *node, gint depth, gboolean arena)
 {
-	GString *root_;
-	gchar *strret;
+	GNode *child;
+	GNode *next;
 
-	if (root == NULL)
-		{
-			root_ = g_string_new ("/");
-		}
-	else
+	for (child = node->children; child != NULL; child = next)
 		{
-			root_ = g_string_new (root);
-			g_strstrip (root_->str);
-			if (g_strcmp0 (root_->str, "") == 0)
-				{
-					g_string_printf (root_, "/");
-				}
-			else
+			next = child->next;
+			if (depth <= 0)
 				{
-					if (root_->str[0] != '/')
+					g_node_unlink (child);
+					if (arena)
 						{
-							g_string_prepend (root_, "/");
+							g_node_destroy (child);
 						}
-					if (root_->str[root_->len - 1] != '/')
+					else
 						{
-							g_string_append (root_, "/");
+							zak_confi_free_tree (child);
 						}
 				}
+			else
+				{
+					zak_confi_tree_prune (child, depth - 1, arena);
+				}
 		}
-
-	strret = g_strdup (root_->str);
-	g_string_free (root_, TRUE);
-
-	return strret;
 }
 
 /**
- * zak_confi_set_root:
+ * zak_confi_get_subtree:
  * @confi: a #ZakConfi object.
- * @root: the root.
+ * @path: the path of the branch; "" or "/" for the root.
+ * @max_depth: the levels to read below @path; negative for all.
  *
+ * Reads only the branch under @path, without building the whole tree
+ * when the plugin supports it.
+ *
+ * Returns: a #GNode rooted at the key of @path, to free with
+ * zak_confi_free_tree(), or NULL if @path doesn't exist.
  */
-gboolean
-zak_confi_set_root (ZakConfi *confi, const gchar *root)
+GNode
+*zak_confi_get_subtree (ZakConfi *confi, const gchar *path, gint max_depth)
 {
-	gboolean ret;
+	GNode *tree;
+	GNode *node;
+	GNode *child;
+	ZakConfiArena *arena;
+	gchar **tokens;
+	gchar *path_;
+	guint i;
 
 	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
 
 	if (priv->pluggable == NULL)
 		{
 			g_warning ("Not initialized.");
-			ret = FALSE;
+			return NULL;
 		}
-	else
+
+	path_ = zak_confi_path_normalize_prefix (confi, path);
+	if (path_ == NULL)
 		{
-			g_object_set (priv->pluggable, "root", root, NULL);
-			ret = TRUE;
+			return NULL;
 		}
 
-	return ret;
+	if (ZAK_CONFI_PLUGGABLE_GET_IFACE (priv->pluggable)->get_subtree != NULL)
+		{
+			tree = zak_confi_pluggable_get_subtree (priv->pluggable, path_, max_depth);
+			g_free (path_);
+			return tree;
+		}
+
+	/* the plugin can only read everything: cutting the branch out */
+	tree = zak_confi_pluggable_get_tree (priv->pluggable);
+	node = tree;
+	tokens = g_strsplit (path_, "/", 0);
+	for (i = 0; node != NULL && tokens[i] != NULL; i++)
+		{
+			if (g_strcmp0 (tokens[i], "") == 0)
+				{
+					continue;
+				}
+			for (child = node->children; child != NULL; child = child->next)
+				{
+					if (g_strcmp0 (((ZakConfiKey *)child->data)->key, tokens[i]) == 0)
+						{
+							break;
+						}
+				}
+			node = child;
+		}
+	g_strfreev (tokens);
+	g_free (path_);
+
+	/* the branch takes the arena with it */
+	arena = (tree != NULL ? zak_confi_arena_steal (tree) : NULL);
+	if (node != NULL && node != tree)
+		{
+			g_node_unlink (node);
+		}
+	if (tree != NULL && node != tree)
+		{
+			if (arena != NULL)
+				{
+					g_node_destroy (tree);
+				}
+			else
+				{
+					zak_confi_free_tree (tree);
+				}
+		}
+	if (arena != NULL)
+		{
+			if (node != NULL)
+				{
+					zak_confi_arena_set_tree (arena, node);
+				}
+			else
+				{
+					zak_confi_arena_free (arena);
+				}
+		}
+
+	if (node != NULL && max_depth >= 0)
+		{
+			zak_confi_tree_prune (node, max_depth, (arena != NULL));
+		}
+
+	return node;
 }
 
-/**
- * zak_confi_add_key:
- * @confi: a #ZakConfi object.
- * @parent: the path where add the key.
- * @key: the key's name.
- * @value: the key's value.
- *
- * Returns: a #ZakConfigKey struct filled with data from the key just added.
- */
-ZakConfiKey
-*zak_confi_add_key (ZakConfi *confi, const gchar *parent, const gchar *key, const gchar *value)
+struct _ZakConfiIter
+	{
+		ZakConfi *confi;
+
+		/* from the plugin; otherwise the keys come from the subtree */
+		gpointer plugin_iter;
+
+		GNode *tree;
+
+		/* the paths of the subtree, sorted => the values in the tree */
+		GTree *keys;
+		GPtrArray *paths;
+		guint n;
+	};
+
+static gint
+zak_confi_iter_compare_paths (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	return strcmp ((const gchar *)a, (const gchar *)b);
+}
+
+static gboolean
+zak_confi_iter_add_node (GNode *node, gpointer data)
 {
 	ZakConfiKey *ck;
 
-	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+	ZakConfiIter *iter = (ZakConfiIter *)data;
 
-	if (priv->pluggable == NULL)
-		{
-			g_warning ("Not initialized.");
-			ck = NULL;
-		}
-	else
+	/* without the root of the subtree */
+	if (node != iter->tree)
 		{
-			ck = zak_confi_pluggable_add_key (priv->pluggable, parent, key, value);
+			ck = (ZakConfiKey *)node->data;
+			g_tree_insert (iter->keys,
+			               g_strconcat ("/",
+			                            (ck->path != NULL ? ck->path : ""),
+			                            (ck->path != NULL && ck->path[0] != '\0' ? "/" : ""),
+			                            ck->key,
+			                            NULL),
+			               ck->value);
 		}
 
-	return ck;
+	return FALSE;
+}
+
+static gboolean
+zak_confi_iter_add_path (gpointer key, gpointer value, gpointer data)
+{
+	g_ptr_array_add ((GPtrArray *)data, key);
+
+	return FALSE;
 }
 
 /**
- * zak_confi_key_set_key:
+ * zak_confi_iter_new:
  * @confi: a #ZakConfi object.
- * @ck: a #ZakConfiKey struct.
+ * @prefix: (nullable): the path of the branch; "" or NULL for the root.
+ *
+ * Returns an iterator over the keys under @prefix, in path order: the
+ * paths are compared byte by byte, so a key comes before the ones under
+ * it. When the plugin supports it, the keys are streamed from the
+ * backend and not kept in memory; otherwise they are read with
+ * zak_confi_get_subtree() and sorted.
  *
+ * Returns: (transfer full): a #ZakConfiIter, to free with
+ * zak_confi_iter_free(); NULL if not initialized.
  */
-gboolean
-zak_confi_key_set_key (ZakConfi *confi,
-                   ZakConfiKey *ck)
+ZakConfiIter
+*zak_confi_iter_new (ZakConfi *confi, const gchar *prefix)
 {
-	gboolean ret;
+	ZakConfiIter *iter;
+	gchar *prefix_;
 
 	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
 
 	if (priv->pluggable == NULL)
 		{
 			g_warning ("Not initialized.");
-			ret = FALSE;
+			return NULL;
 		}
-	else
+
+	iter = g_slice_new0 (ZakConfiIter);
+	iter->confi = g_object_ref (confi);
+
+	prefix_ = zak_confi_path_normalize_prefix (confi, prefix);
+	if (prefix_ != NULL)
 		{
-			ret = zak_confi_pluggable_key_set_key (priv->pluggable, ck);
+			iter->plugin_iter = zak_confi_pluggable_iter_new (priv->pluggable, prefix_);
+			if (iter->plugin_iter == NULL)
+				{
+					iter->tree = zak_confi_get_subtree (confi, prefix, -1);
+					if (iter->tree != NULL)
+						{
+							iter->keys = g_tree_new_full (zak_confi_iter_compare_paths, NULL, g_free, NULL);
+							g_node_traverse (iter->tree, G_PRE_ORDER, G_TRAVERSE_ALL, -1, zak_confi_iter_add_node, iter);
+							iter->paths = g_ptr_array_sized_new (g_tree_nnodes (iter->keys));
+							g_tree_foreach (iter->keys, zak_confi_iter_add_path, iter->paths);
+						}
+				}
+			g_free (prefix_);
 		}
 
-	return ret;
+	return iter;
 }
 
 /**
- * zak_confi_remove_path:
- * @confi: a #ZakConfi object.
- * @path: the path to remove.
+ * zak_confi_iter_next:
+ * @iter: a #ZakConfiIter.
+ * @path: (out) (transfer none): the absolute path of the next key.
+ * @value: (out) (transfer none) (nullable): its value.
  *
- * Removes @path and every child key.
+ * The strings returned are valid until the next call.
+ *
+ * Returns: #FALSE when there are no more keys.
  */
 gboolean
-zak_confi_remove_path (ZakConfi *confi, const gchar *path)
+zak_confi_iter_next (ZakConfiIter *iter, const gchar **path, const gchar **value)
 {
-	gboolean ret;
-	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+	g_return_val_if_fail (iter != NULL, FALSE);
 
-	if (priv->pluggable == NULL)
+	if (iter->plugin_iter != NULL)
 		{
-			g_warning ("Not initialized.");
-			ret = FALSE;
+			ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (iter->confi);
+
+			return zak_confi_pluggable_iter_next (priv->pluggable, iter->plugin_iter, path, value);
 		}
-	else
+
+	if (iter->paths == NULL
+	    || iter->n >= iter->paths->len)
 		{
-			ret = zak_confi_pluggable_remove_path (priv->pluggable, path);
+			return FALSE;
 		}
 
-	return ret;
+	*path = (const gchar *)g_ptr_array_index (iter->paths, iter->n);
+	*value = (const gchar *)g_tree_lookup (iter->keys, *path);
+	iter->n++;
+
+	return TRUE;
 }
 
 /**
- * zak_confi_path_get_value:
- * @confi: a #ZakConfi object.
- * @path: the path from which retrieving the value.
+ * zak_confi_iter_free:
+ * @iter: a #ZakConfiIter.
  *
- * Returns: the configuration's value as a string.
  */
-gchar
-*zak_confi_path_get_value (ZakConfi *confi, const gchar *path)
+void
+zak_confi_iter_free (ZakConfiIter *iter)
 {
-	gchar *ret;
+	g_return_if_fail (iter != NULL);
 
-	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+	if (iter->plugin_iter != NULL)
+		{
+			ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (iter->confi);
 
-	if (priv->pluggable == NULL)
+			zak_confi_pluggable_iter_free (priv->pluggable, iter->plugin_iter);
+		}
+	if (iter->paths != NULL)
 		{
-			g_warning ("Not initialized.");
-			ret = NULL;
+			g_ptr_array_free (iter->paths, TRUE);
+			g_tree_unref (iter->keys);
 		}
-	else
+	if (iter->tree != NULL)
 		{
-			ret = zak_confi_pluggable_path_get_value (priv->pluggable, path);
+			zak_confi_free_tree (iter->tree);
 		}
-
-	return ret;
+	g_object_unref (iter->confi);
+	g_slice_free (ZakConfiIter, iter);
 }
 
 /**
- * zak_confi_path_set_value:
+ * zak_confi_foreach:
  * @confi: a #ZakConfi object.
- * @path: the key's path.
- * @value: the value to set.
+ * @prefix: (nullable): the path of the branch; "" or NULL for the root.
+ * @func: (scope call): the function to call for every key; it stops the
+ * iteration returning #TRUE.
+ * @user_data: data for @func.
  *
+ * Calls @func for every key under @prefix, in path order, as they are
+ * read from the backend; see zak_confi_iter_new().
  */
-gboolean
-zak_confi_path_set_value (ZakConfi *confi, const gchar *path, const gchar *value)
+void
+zak_confi_foreach (ZakConfi *confi,
+                   const gchar *prefix,
+                   ZakConfiForeachFunc func,
+                   gpointer user_data)
 {
-	gboolean ret;
+	ZakConfiIter *iter;
+	const gchar *path;
+	const gchar *value;
 
-	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+	g_return_if_fail (func != NULL);
 
-	if (priv->pluggable == NULL)
+	iter = zak_confi_iter_new (confi, prefix);
+	if (iter == NULL)
 		{
-			g_warning ("Not initialized.");
-			ret = FALSE;
+			return;
 		}
-	else
+
+	while (zak_confi_iter_next (iter, &path, &value))
 		{
-			ret = zak_confi_pluggable_path_set_value (priv->pluggable, path, value);
+			if (func (confi, path, value, user_data))
+				{
+					break;
+				}
 		}
 
-	return ret;
+	zak_confi_iter_free (iter);
 }
 
 /**
- * zak_confi_path_get_confi_key:
+ * zak_confi_snapshot_new:
  * @confi: a #ZakConfi object.
- * @path: the key's path to get.
  *
- * Returns: (transfer full): a #ZakConfiKey from @path
+ * Reads the whole configuration and returns it as an immutable flat
+ * path->value structure, with the current root. Its values can be read
+ * by any number of threads without locks; after a reload publish the new
+ * one with zak_confi_snapshot_exchange(), and take the published one with
+ * zak_confi_snapshot_acquire(), that locks only the shared pointer.
+ *
+ * Returns: (transfer full): a #ZakConfiSnapshot, or NULL if it fails.
  */
-ZakConfiKey
-*zak_confi_path_get_confi_key (ZakConfi *confi, const gchar *path)
+ZakConfiSnapshot
+*zak_confi_snapshot_new (ZakConfi *confi)
 {
-	ZakConfiKey *ck;
+	ZakConfiSnapshot *snapshot;
+	GNode *tree;
+	gchar *root;
 
 	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
 
 	if (priv->pluggable == NULL)
 		{
 			g_warning ("Not initialized.");
-			ck = NULL;
+			return NULL;
+		}
+
+	tree = zak_confi_pluggable_get_tree (priv->pluggable);
+	if (tree == NULL)
+		{
+			return NULL;
+		}
+
+	g_object_get (priv->pluggable, "root", &root, NULL);
+	snapshot = zak_confi_snapshot_new_from_tree (tree, root);
+	g_free (root);
+
+	zak_confi_free_tree (tree);
+
+	return snapshot;
+}
+
+/**
+ * zak_confi_get_tree_compact:
+ * @confi: a #ZakConfi object.
+ *
+ * As zak_confi_get_tree(), but in a #ZakConfiTree: one array of nodes
+ * with sorted children and one block of strings, to walk and search
+ * without chasing pointers, and to free at once.
+ *
+ * Returns: (transfer full): a #ZakConfiTree, or NULL if it fails.
+ */
+ZakConfiTree
+*zak_confi_get_tree_compact (ZakConfi *confi)
+{
+	ZakConfiTree *ctree;
+	GNode *tree;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			return NULL;
+		}
+
+	tree = zak_confi_pluggable_get_tree (priv->pluggable);
+	if (tree == NULL)
+		{
+			return NULL;
+		}
+
+	ctree = zak_confi_tree_new_from_tree (tree);
+
+	zak_confi_free_tree (tree);
+
+	return ctree;
+}
+
+/**
+ * zak_confi_normalize_set_root:
+ * @confi: a #ZakConfi object.
+ * @root: the root.
+ *
+ * Returns: a correct value for root property.
+ */
+gchar
+*zak_confi_normalize_root (const gchar *root)
+{
+	GString *root_;
+	gchar *strret;
+
+	if (root == NULL)
+		{
+			root_ = g_string_new ("/");
 		}
 	else
 		{
-			ck = zak_confi_pluggable_path_get_confi_key (priv->pluggable, path);
+			root_ = g_string_new (root);
+			g_strstrip (root_->str);
+			if (g_strcmp0 (root_->str, "") == 0)
+				{
+					g_string_printf (root_, "/");
+				}
+			else
+				{
+					if (root_->str[0] != '/')
+						{
+							g_string_prepend (root_, "/");
+						}
+					if (root_->str[root_->len - 1] != '/')
+						{
+							g_string_append (root_, "/");
+						}
+				}
 		}
 
-	return ck;
+	strret = g_strdup (root_->str);
+	g_string_free (root_, TRUE);
+
+	return strret;
 }
 
 /**
- * zak_confi_remove:
+ * zak_confi_set_root:
  * @confi: a #ZakConfi object.
+ * @root: the root.
  *
- * Remove a configuration from databases and destroy the relative object.
  */
 gboolean
-zak_confi_remove (ZakConfi *confi)
+zak_confi_set_root (ZakConfi *confi, const gchar *root)
 {
 	gboolean ret;
 
@@ -492,117 +988,2968 @@ zak_confi_remove (ZakConfi *confi)
 		}
 	else
 		{
-			ret = zak_confi_pluggable_remove (priv->pluggable);
-		}
-
-	if (ret)
-		{
-			zak_confi_destroy (confi);
+			/* the cache is keyed by the normalized path, that already
+			 * contains the root: changing it doesn't invalidate anything */
+			g_object_set (priv->pluggable, "root", root, NULL);
+			g_atomic_int_inc (&priv->serial);
+			ret = TRUE;
 		}
 
 	return ret;
 }
 
 /**
- * zak_confi_destroy:
+ * zak_confi_set_intern_values:
  * @confi: a #ZakConfi object.
+ * @intern: TRUE to share the equal values.
  *
- * Destroy the #ZakConfi object, freeing memory.
+ * The trees read by the plugins always keep one copy of every key name
+ * and path; with @intern also the equal values and descriptions are
+ * stored once. It affects the trees read afterwards.
  */
 void
-zak_confi_destroy (ZakConfi *confi)
+zak_confi_set_intern_values (ZakConfi *confi, gboolean intern)
 {
 	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
 
-	g_free (priv->name);
-	g_free (priv->description);
-	g_free (priv->root);
-	g_object_unref (priv->pluggable);
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			return;
+		}
+
+	g_object_set (priv->pluggable, "intern_values", intern, NULL);
 }
 
 /**
- * zak_confi_path_normalize:
- * @pluggable: a #ZakConfiPluggable object.
+ * zak_confi_add_key:
+ * @confi: a #ZakConfi object.
+ * @parent: the path where add the key.
+ * @key: the key's name.
+ * @value: the key's value.
  *
- * Returns: a normalize path (with root).
+ * Returns: a #ZakConfigKey struct filled with data from the key just added.
  */
-gchar
-*zak_confi_path_normalize (ZakConfiPluggable *pluggable, const gchar *path)
+ZakConfiKey
+*zak_confi_add_key (ZakConfi *confi, const gchar *parent, const gchar *key, const gchar *value)
 {
-	GString *ret;
-	gchar *strret;
-
-	guint lead;
+	ZakConfiKey *ck;
+	gchar *path;
+	gchar *path_;
 
-	gchar *root;
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
 
-	if (path == NULL)
+	if (priv->pluggable == NULL)
 		{
-			return NULL;
+			g_warning ("Not initialized.");
+			ck = NULL;
 		}
-
-	ret = g_string_new (path);
-	g_strstrip (ret->str);
-	if (g_strcmp0 (ret->str, "") == 0)
+	else
 		{
-			return NULL;
+			ck = zak_confi_pluggable_add_key (priv->pluggable, parent, key, value);
+			if (ck != NULL)
+				{
+					g_atomic_int_inc (&priv->serial);
+					path = g_build_path ("/", (parent != NULL ? parent : ""), key, NULL);
+					path_ = zak_confi_path_normalize (priv->pluggable, path);
+					if (path_ != NULL)
+						{
+							zak_confi_absent_remove_ancestors (confi, path_);
+							g_free (path_);
+						}
+					zak_confi_changed (confi, path);
+					g_free (path);
+				}
 		}
-	else if (ret->str[strlen (ret->str) - 1] == '/')
+
+	return ck;
+}
+
+/**
+ * zak_confi_key_set_key:
+ * @confi: a #ZakConfi object.
+ * @ck: a #ZakConfiKey struct.
+ *
+ */
+gboolean
+zak_confi_key_set_key (ZakConfi *confi,
+                   ZakConfiKey *ck)
+{
+	gboolean ret;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->pluggable == NULL)
 		{
-			return NULL;
+			g_warning ("Not initialized.");
+			ret = FALSE;
 		}
-
-	/* removing leading '/' */
-	lead = 0;
-	for (lead = 0; lead < ret->len; lead++)
+	else
 		{
-			if (ret->str[lead] != '/')
+			ret = zak_confi_pluggable_key_set_key (priv->pluggable, ck);
+			if (ret)
 				{
-					break;
+					/* the key could be renamed, with all its children */
+					g_atomic_int_inc (&priv->serial);
+					zak_confi_absent_clear (confi);
+					zak_confi_changed (confi, NULL);
 				}
 		}
 
-	if (lead < ret->len)
-		{
-			g_string_erase (ret, 0, lead++);
-		}
+	return ret;
+}
 
-	g_object_get (pluggable, "root", &root, NULL);
-	g_string_prepend (ret, root);
+/**
+ * zak_confi_remove_path:
+ * @confi: a #ZakConfi object.
+ * @path: the path to remove.
+ *
+ * Removes @path and every child key.
+ */
+gboolean
+zak_confi_remove_path (ZakConfi *confi, const gchar *path)
+{
+	gboolean ret;
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
 
-	strret = g_strdup (ret->str);
-	g_string_free (ret, TRUE);
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			ret = FALSE;
+		}
+	else
+		{
+			ret = zak_confi_pluggable_remove_path (priv->pluggable, path);
+			if (ret)
+				{
+					g_atomic_int_inc (&priv->serial);
+					zak_confi_changed (confi, path);
+				}
+		}
 
-	return strret;
+	return ret;
 }
 
-/* PRIVATE */
-static void
-zak_confi_set_property (GObject *object, guint property_id, const GValue *value, GParamSpec *pspec)
+/**
+ * zak_confi_path_get_value:
+ * @confi: a #ZakConfi object.
+ * @path: the path from which retrieving the value.
+ *
+ * Returns: the configuration's value as a string.
+ */
+gchar
+*zak_confi_path_get_value (ZakConfi *confi, const gchar *path)
 {
-	gchar *sql;
+	gchar *ret;
 
-	ZakConfi *confi = ZAK_CONFI (object);
 	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
 
-	switch (property_id)
+	if (priv->pluggable == NULL)
 		{
-			default:
-				G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
-				break;
+			g_warning ("Not initialized.");
+			ret = NULL;
+		}
+	else
+		{
+			ret = zak_confi_cache_lookup (confi, path);
 		}
+
+	return ret;
 }
 
-static void
-zak_confi_get_property (GObject *object, guint property_id, GValue *value, GParamSpec *pspec)
+/**
+ * zak_confi_path_lookup_value:
+ * @confi: a #ZakConfi object.
+ * @path: the path from which retrieving the value.
+ *
+ * As zak_confi_path_get_value(), for the optional keys: a missing key
+ * isn't logged. With the cache enabled, the missing paths are
+ * remembered until a key is added there; with the whole subtree of their
+ * topmost missing parent, when the plugin knows it.
+ *
+ * Returns: the configuration's value as a string, or NULL.
+ */
+gchar
+*zak_confi_path_lookup_value (ZakConfi *confi, const gchar *path)
 {
-	ZakConfi *confi = ZAK_CONFI (object);
 	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
 
-	switch (property_id)
+	if (priv->pluggable == NULL)
 		{
-			default:
-				G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+			g_warning ("Not initialized.");
+			return NULL;
+		}
+
+	return zak_confi_cache_lookup_full (confi, path, TRUE);
+}
+
+/**
+ * zak_confi_path_get_int:
+ * @confi: a #ZakConfi object.
+ * @path: the path from which retrieving the value.
+ * @default_value: the value returned if @path doesn't exist or isn't an
+ * integer.
+ *
+ * The parsed value is kept in the cache together with the string, so
+ * the following reads don't parse it again.
+ *
+ * Returns: the configuration's value as an integer.
+ */
+gint
+zak_confi_path_get_int (ZakConfi *confi, const gchar *path, gint default_value)
+{
+	ZakConfiParsedValue parsed;
+
+	return (zak_confi_cache_lookup_parsed (confi, path, ZAK_CONFI_PARSED_INT, &parsed) ? parsed.v_int : default_value);
+}
+
+/**
+ * zak_confi_path_get_boolean:
+ * @confi: a #ZakConfi object.
+ * @path: the path from which retrieving the value.
+ * @default_value: the value returned if @path doesn't exist or isn't a
+ * boolean (true/false, yes/no, 1/0).
+ *
+ * Returns: the configuration's value as a boolean.
+ */
+gboolean
+zak_confi_path_get_boolean (ZakConfi *confi, const gchar *path, gboolean default_value)
+{
+	ZakConfiParsedValue parsed;
+
+	return (zak_confi_cache_lookup_parsed (confi, path, ZAK_CONFI_PARSED_BOOLEAN, &parsed) ? parsed.v_boolean : default_value);
+}
+
+/**
+ * zak_confi_path_get_double:
+ * @confi: a #ZakConfi object.
+ * @path: the path from which retrieving the value.
+ * @default_value: the value returned if @path doesn't exist or isn't a
+ * number.
+ *
+ * Returns: the configuration's value as a double.
+ */
+gdouble
+zak_confi_path_get_double (ZakConfi *confi, const gchar *path, gdouble default_value)
+{
+	ZakConfiParsedValue parsed;
+
+	return (zak_confi_cache_lookup_parsed (confi, path, ZAK_CONFI_PARSED_DOUBLE, &parsed) ? parsed.v_double : default_value);
+}
+
+/**
+ * zak_confi_path_get_strv:
+ * @confi: a #ZakConfi object.
+ * @path: the path from which retrieving the value.
+ * @default_value: (array zero-terminated=1) (nullable): the value
+ * returned if @path doesn't exist.
+ *
+ * The value is split on ';', as the lists of #GKeyFile.
+ *
+ * Returns: (transfer full) (array zero-terminated=1): a copy of the
+ * configuration's value as a list of strings, or of @default_value.
+ */
+gchar
+**zak_confi_path_get_strv (ZakConfi *confi, const gchar *path, const gchar * const *default_value)
+{
+	ZakConfiParsedValue parsed;
+
+	if (zak_confi_cache_lookup_parsed (confi, path, ZAK_CONFI_PARSED_STRV, &parsed))
+		{
+			return parsed.v_strv;
+		}
+
+	return g_strdupv ((gchar **)default_value);
+}
+
+/**
+ * zak_confi_paths_get_values:
+ * @confi: a #ZakConfi object.
+ * @paths: (array zero-terminated=1): the paths from which retrieving the values.
+ *
+ * Reads many values at once: the ones not in cache are requested to the
+ * backend with only one call, if the plugin supports it.
+ *
+ * Returns: (transfer full) (element-type utf8 utf8): a #GHashTable with
+ * the values keyed by path, as passed in @paths; paths that don't exist
+ * are missing.
+ */
+GHashTable
+*zak_confi_paths_get_values (ZakConfi *confi, const gchar **paths)
+{
+	GHashTable *ret;
+	GHashTable *values;
+	GPtrArray *missing;
+	gchar *value;
+	guint i;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			return NULL;
+		}
+
+	ret = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+	missing = zak_confi_paths_get_cached (confi, paths, ret);
+	if (missing->len > 0)
+		{
+			if (ZAK_CONFI_PLUGGABLE_GET_IFACE (priv->pluggable)->paths_get_values != NULL)
+				{
+					g_ptr_array_add (missing, NULL);
+					values = zak_confi_pluggable_paths_get_values (priv->pluggable, (const gchar **)missing->pdata);
+				}
+			else
+				{
+					values = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+					for (i = 0; i < missing->len; i++)
+						{
+							value = zak_confi_pluggable_path_get_value (priv->pluggable, (gchar *)g_ptr_array_index (missing, i));
+							if (value != NULL)
+								{
+									g_hash_table_replace (values, g_strdup ((gchar *)g_ptr_array_index (missing, i)), value);
+								}
+						}
+				}
+
+			zak_confi_paths_add_values (confi, ret, values);
+
+			/* remembering the missing ones */
+			for (i = 0; priv->cache_size > 0 && i < missing->len && g_ptr_array_index (missing, i) != NULL; i++)
+				{
+					if (!g_hash_table_contains (ret, g_ptr_array_index (missing, i)))
+						{
+							zak_confi_absent_insert (confi, zak_confi_path_normalize (priv->pluggable, (gchar *)g_ptr_array_index (missing, i)), FALSE);
+						}
+				}
+		}
+	g_ptr_array_free (missing, TRUE);
+
+	return ret;
+}
+
+/**
+ * zak_confi_path_set_value:
+ * @confi: a #ZakConfi object.
+ * @path: the key's path.
+ * @value: the value to set.
+ *
+ */
+gboolean
+zak_confi_path_set_value (ZakConfi *confi, const gchar *path, const gchar *value)
+{
+	gboolean ret;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			ret = FALSE;
+		}
+	else
+		{
+			ret = zak_confi_pluggable_path_set_value (priv->pluggable, path, value);
+			if (ret)
+				{
+					zak_confi_path_set_value_done (confi, path);
+				}
+		}
+
+	return ret;
+}
+
+struct _ZakConfiPathHandle
+	{
+		ZakConfi *confi;
+		gchar *path;
+
+		/* valid while serial is the one of the ZakConfi */
+		gint serial;
+		gchar *normalized;
+		gint id;
+	};
+
+/* normalizes the path and resolves the key id again, if the root or the
+ * structure changed since the last time */
+static void
+zak_confi_path_handle_resolve (ZakConfiPathHandle *handle)
+{
+	gint serial;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (handle->confi);
+
+	serial = g_atomic_int_get (&priv->serial);
+	if (handle->normalized != NULL
+	    && handle->serial == serial)
+		{
+			return;
+		}
+
+	g_free (handle->normalized);
+	handle->normalized = zak_confi_path_normalize (priv->pluggable, handle->path);
+	handle->id = (handle->normalized != NULL ? zak_confi_pluggable_path_get_key_id (priv->pluggable, handle->normalized) : -1);
+	handle->serial = serial;
+}
+
+/**
+ * zak_confi_path_compile:
+ * @confi: a #ZakConfi object.
+ * @path: the key's path.
+ *
+ * Normalizes @path and resolves it in the backend once, for the paths
+ * read or written many times; the handle is resolved again by itself
+ * when the root or the keys structure changes.
+ *
+ * Returns: (transfer full): a #ZakConfiPathHandle, to free with
+ * zak_confi_path_handle_free(); NULL if @path isn't valid.
+ */
+ZakConfiPathHandle
+*zak_confi_path_compile (ZakConfi *confi, const gchar *path)
+{
+	ZakConfiPathHandle *handle;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			return NULL;
+		}
+
+	handle = g_slice_new0 (ZakConfiPathHandle);
+	handle->confi = g_object_ref (confi);
+	handle->path = g_strdup (path);
+	handle->id = -1;
+
+	zak_confi_path_handle_resolve (handle);
+	if (handle->normalized == NULL)
+		{
+			zak_confi_path_handle_free (handle);
+			return NULL;
+		}
+
+	return handle;
+}
+
+/**
+ * zak_confi_path_handle_free:
+ * @handle: a #ZakConfiPathHandle.
+ *
+ */
+void
+zak_confi_path_handle_free (ZakConfiPathHandle *handle)
+{
+	g_return_if_fail (handle != NULL);
+
+	g_object_unref (handle->confi);
+	g_free (handle->path);
+	g_free (handle->normalized);
+	g_slice_free (ZakConfiPathHandle, handle);
+}
+
+/**
+ * zak_confi_handle_get_value:
+ * @handle: a #ZakConfiPathHandle.
+ *
+ * As zak_confi_path_get_value(), reaching the key by its id when the
+ * plugin supports it.
+ *
+ * Returns: the configuration's value as a string.
+ */
+gchar
+*zak_confi_handle_get_value (ZakConfiPathHandle *handle)
+{
+	gchar *ret;
+
+	ZakConfiPrivate *priv;
+
+	g_return_val_if_fail (handle != NULL, NULL);
+
+	priv = ZAK_CONFI_GET_PRIVATE (handle->confi);
+
+	zak_confi_path_handle_resolve (handle);
+	if (handle->normalized == NULL)
+		{
+			return NULL;
+		}
+
+	ret = (priv->cache_size > 0 ? zak_confi_cache_get (handle->confi, handle->normalized) : NULL);
+	if (ret == NULL)
+		{
+			if (handle->id >= 0)
+				{
+					ret = zak_confi_pluggable_key_id_get_value (priv->pluggable, handle->id);
+				}
+			else
+				{
+					ret = zak_confi_pluggable_path_get_value (priv->pluggable, handle->path);
+				}
+			if (ret != NULL && priv->cache_size > 0)
+				{
+					zak_confi_cache_insert (handle->confi, handle->normalized, ret);
+				}
+		}
+
+	return ret;
+}
+
+/**
+ * zak_confi_handle_set_value:
+ * @handle: a #ZakConfiPathHandle.
+ * @value: the value to set.
+ *
+ * As zak_confi_path_set_value(), reaching the key by its id when the
+ * plugin supports it.
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_handle_set_value (ZakConfiPathHandle *handle, const gchar *value)
+{
+	gboolean ret;
+
+	ZakConfiPrivate *priv;
+
+	g_return_val_if_fail (handle != NULL, FALSE);
+
+	priv = ZAK_CONFI_GET_PRIVATE (handle->confi);
+
+	zak_confi_path_handle_resolve (handle);
+	if (handle->normalized == NULL)
+		{
+			return FALSE;
+		}
+
+	if (handle->id >= 0)
+		{
+			ret = zak_confi_pluggable_key_id_set_value (priv->pluggable, handle->id, value);
+			if (!ret)
+				{
+					/* the key could be gone: resolved again the next time */
+					g_free (handle->normalized);
+					handle->normalized = NULL;
+				}
+		}
+	else
+		{
+			ret = zak_confi_pluggable_path_set_value (priv->pluggable, handle->path, value);
+			if (ret)
+				{
+					/* the key could be created: its id the next time */
+					g_free (handle->normalized);
+					handle->normalized = NULL;
+				}
+		}
+	if (ret)
+		{
+			/* only a value: the other handles stay valid */
+			zak_confi_path_set_value_done (handle->confi, handle->path);
+		}
+
+	return ret;
+}
+
+/**
+ * zak_confi_path_get_confi_key:
+ * @confi: a #ZakConfi object.
+ * @path: the key's path to get.
+ *
+ * Returns: (transfer full): a #ZakConfiKey from @path
+ */
+ZakConfiKey
+*zak_confi_path_get_confi_key (ZakConfi *confi, const gchar *path)
+{
+	ZakConfiKey *ck;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			ck = NULL;
+		}
+	else
+		{
+			ck = zak_confi_pluggable_path_get_confi_key (priv->pluggable, path);
+		}
+
+	return ck;
+}
+
+/**
+ * zak_confi_begin:
+ * @confi: a #ZakConfi object.
+ *
+ * Starts a transaction: the following changes are written to the backend
+ * all together by zak_confi_commit(), or discarded by zak_confi_rollback().
+ * If the plugin doesn't support transactions, every change is still
+ * written immediately.
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_begin (ZakConfi *confi)
+{
+	gboolean ret;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			ret = FALSE;
+		}
+	else if (ZAK_CONFI_PLUGGABLE_GET_IFACE (priv->pluggable)->begin == NULL)
+		{
+			ret = TRUE;
+		}
+	else
+		{
+			ret = zak_confi_pluggable_begin (priv->pluggable);
+		}
+
+	return ret;
+}
+
+/**
+ * zak_confi_commit:
+ * @confi: a #ZakConfi object.
+ *
+ * Writes every change made since zak_confi_begin().
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_commit (ZakConfi *confi)
+{
+	gboolean ret;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			ret = FALSE;
+		}
+	else if (ZAK_CONFI_PLUGGABLE_GET_IFACE (priv->pluggable)->commit == NULL)
+		{
+			ret = TRUE;
+		}
+	else
+		{
+			ret = zak_confi_pluggable_commit (priv->pluggable);
+		}
+
+	return ret;
+}
+
+/**
+ * zak_confi_rollback:
+ * @confi: a #ZakConfi object.
+ *
+ * Discards every change made since zak_confi_begin().
+ *
+ * Returns: #TRUE if success; #FALSE also if the plugin doesn't support transactions.
+ */
+gboolean
+zak_confi_rollback (ZakConfi *confi)
+{
+	gboolean ret;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			ret = FALSE;
+		}
+	else if (ZAK_CONFI_PLUGGABLE_GET_IFACE (priv->pluggable)->rollback == NULL)
+		{
+			g_warning ("Transactions not supported by the plugin.");
+			ret = FALSE;
+		}
+	else
+		{
+			ret = zak_confi_pluggable_rollback (priv->pluggable);
+		}
+
+	/* the cache could contain values read inside the transaction */
+	if (ret)
+		{
+			g_atomic_int_inc (&priv->serial);
+			zak_confi_absent_clear (confi);
+			zak_confi_changed (confi, NULL);
+		}
+	else
+		{
+			zak_confi_cache_remove_prefix (confi, NULL);
+		}
+
+	return ret;
+}
+
+/**
+ * zak_confi_flush:
+ * @confi: a #ZakConfi object.
+ *
+ * Writes immediately the changes whose saving is deferred by the plugin
+ * (e.g. the file plugin with SAVE_DELAY).
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_flush (ZakConfi *confi)
+{
+	gboolean ret;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			ret = FALSE;
+		}
+	else if (ZAK_CONFI_PLUGGABLE_GET_IFACE (priv->pluggable)->flush == NULL)
+		{
+			ret = TRUE;
+		}
+	else
+		{
+			ret = zak_confi_pluggable_flush (priv->pluggable);
+		}
+
+	return ret;
+}
+
+/**
+ * zak_confi_get_revision:
+ * @confi: a #ZakConfi object.
+ *
+ * Returns: the revision of the configuration, incremented by every write;
+ * -1 if the plugin doesn't track the changes.
+ */
+gint64
+zak_confi_get_revision (ZakConfi *confi)
+{
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			return -1;
+		}
+
+	return zak_confi_pluggable_get_revision (priv->pluggable);
+}
+
+/**
+ * zak_confi_get_changes_since:
+ * @confi: a #ZakConfi object.
+ * @revision: a revision returned by zak_confi_get_revision().
+ *
+ * Reads only the keys written or removed after @revision, dropping them
+ * from the cache and emitting ZakConfi::changed for each of them; a
+ * client that keeps the last revision seen can refresh its copy without
+ * reading the whole configuration again.
+ *
+ * Returns: (transfer full) (element-type utf8 utf8) (nullable): the
+ * absolute paths with their new values, NULL for the removed ones;
+ * NULL if the plugin doesn't track the changes, or no more knows the
+ * ones since @revision: then read the whole configuration again.
+ */
+GHashTable
+*zak_confi_get_changes_since (ZakConfi *confi, gint64 revision)
+{
+	GHashTable *ret;
+	GHashTableIter iter;
+	gchar *path;
+	gchar *value;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			return NULL;
+		}
+
+	ret = zak_confi_pluggable_get_changes_since (priv->pluggable, revision);
+	if (ret != NULL)
+		{
+			g_hash_table_iter_init (&iter, ret);
+			while (g_hash_table_iter_next (&iter, (gpointer *)&path, (gpointer *)&value))
+				{
+					zak_confi_on_pluggable_changed (priv->pluggable, path, confi);
+				}
+		}
+
+	return ret;
+}
+
+/**
+ * zak_confi_remove:
+ * @confi: a #ZakConfi object.
+ *
+ * Remove a configuration from databases and destroy the relative object.
+ */
+gboolean
+zak_confi_remove (ZakConfi *confi)
+{
+	gboolean ret;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			ret = FALSE;
+		}
+	else
+		{
+			ret = zak_confi_pluggable_remove (priv->pluggable);
+		}
+
+	if (ret)
+		{
+			zak_confi_changed (confi, NULL);
+			zak_confi_destroy (confi);
+		}
+
+	return ret;
+}
+
+/**
+ * zak_confi_destroy:
+ * @confi: a #ZakConfi object.
+ *
+ * Destroy the #ZakConfi object, freeing memory.
+ */
+void
+zak_confi_destroy (ZakConfi *confi)
+{
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	g_free (priv->name);
+	g_free (priv->description);
+	g_free (priv->root);
+	zak_confi_set_cache_size (confi, 0);
+	g_signal_handlers_disconnect_by_data (priv->pluggable, confi);
+	g_object_unref (priv->pluggable);
+}
+
+/**
+ * zak_confi_set_cache_size:
+ * @confi: a #ZakConfi object.
+ * @size: the maximum number of values to keep in cache; 0 disables the cache.
+ *
+ * Enables the read-through cache of the values read with
+ * zak_confi_path_get_value(). When the cache is full, the least recently
+ * used value is discarded.
+ */
+void
+zak_confi_set_cache_size (ZakConfi *confi, guint size)
+{
+	ZakConfiCacheEntry *entry;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	g_mutex_lock (&priv->cache_lock);
+
+	priv->cache_size = size;
+	if (size == 0)
+		{
+			if (priv->values != NULL)
+				{
+					g_hash_table_destroy (priv->values);
+					priv->values = NULL;
+				}
+			g_queue_clear (&priv->lru);
+
+			if (priv->absent != NULL)
+				{
+					g_hash_table_destroy (priv->absent);
+					priv->absent = NULL;
+				}
+			g_queue_clear (&priv->absent_fifo);
+			if (priv->absent_branches != NULL)
+				{
+					g_hash_table_destroy (priv->absent_branches);
+					priv->absent_branches = NULL;
+				}
+			g_queue_clear (&priv->absent_branches_fifo);
+		}
+	else
+		{
+			if (priv->values == NULL)
+				{
+					priv->values = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, zak_confi_cache_entry_free);
+				}
+			while (priv->lru.length > size)
+				{
+					entry = (ZakConfiCacheEntry *)g_queue_pop_tail (&priv->lru);
+					g_hash_table_remove (priv->values, entry->path);
+				}
+			while (priv->absent_fifo.length > size)
+				{
+					g_hash_table_remove (priv->absent, g_queue_pop_tail (&priv->absent_fifo));
+				}
+			while (priv->absent_branches_fifo.length > size)
+				{
+					g_hash_table_remove (priv->absent_branches, g_queue_pop_tail (&priv->absent_branches_fifo));
+				}
+		}
+
+	g_mutex_unlock (&priv->cache_lock);
+}
+
+/**
+ * zak_confi_get_cache_size:
+ * @confi: a #ZakConfi object.
+ *
+ * Returns: the maximum number of values kept in cache; 0 if the cache is disabled.
+ */
+guint
+zak_confi_get_cache_size (ZakConfi *confi)
+{
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	return priv->cache_size;
+}
+
+/**
+ * zak_confi_get_cache_stats:
+ * @confi: a #ZakConfi object.
+ * @hits: (out) (allow-none): number of values returned from the cache.
+ * @misses: (out) (allow-none): number of values read from the backend.
+ * @size: (out) (allow-none): number of values currently in cache.
+ *
+ * Reads the counters of the values cache, set with
+ * zak_confi_set_cache_size(); they are reset by zak_confi_cache_clear().
+ */
+void
+zak_confi_get_cache_stats (ZakConfi *confi, guint *hits, guint *misses, guint *size)
+{
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	g_mutex_lock (&priv->cache_lock);
+	if (hits != NULL)
+		{
+			*hits = priv->cache_hits;
+		}
+	if (misses != NULL)
+		{
+			*misses = priv->cache_misses;
+		}
+	if (size != NULL)
+		{
+			*size = priv->lru.length;
+		}
+	g_mutex_unlock (&priv->cache_lock);
+}
+
+/**
+ * zak_confi_cache_clear:
+ * @confi: a #ZakConfi object.
+ *
+ * Discards every value in cache and resets the counters.
+ */
+void
+zak_confi_cache_clear (ZakConfi *confi)
+{
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	zak_confi_cache_remove_prefix (confi, NULL);
+	zak_confi_absent_clear (confi);
+
+	g_mutex_lock (&priv->cache_lock);
+	priv->cache_hits = 0;
+	priv->cache_misses = 0;
+	g_mutex_unlock (&priv->cache_lock);
+}
+
+static void
+zak_confi_watch_on_changed (ZakConfi *confi, const gchar *path, gpointer user_data)
+{
+	ZakConfiWatch *watch = (ZakConfiWatch *)user_data;
+
+	/* a change of an ancestor involves the watched subtree too */
+	if (watch->prefix == NULL
+	    || zak_confi_path_is_below (path, watch->prefix)
+	    || zak_confi_path_is_below (watch->prefix, path))
+		{
+			watch->func (confi, path, watch->user_data);
+		}
+}
+
+static void
+zak_confi_watch_free (gpointer data, GClosure *closure)
+{
+	ZakConfiWatch *watch = (ZakConfiWatch *)data;
+
+	if (watch->notify != NULL)
+		{
+			watch->notify (watch->user_data);
+		}
+	g_free (watch->prefix);
+	g_slice_free (ZakConfiWatch, watch);
+}
+
+/**
+ * zak_confi_watch:
+ * @confi: a #ZakConfi object.
+ * @prefix: (nullable): the path to watch, with every key below it;
+ * NULL or empty for the whole configuration.
+ * @func: the function to call on every change.
+ * @user_data: data for @func.
+ * @notify: (nullable): function to free @user_data.
+ *
+ * Calls @func, from #ZakConfi::changed, for every change of @prefix, of
+ * a key below it or of one of its ancestors.
+ *
+ * Returns: the id of the watch, for zak_confi_unwatch().
+ */
+gulong
+zak_confi_watch (ZakConfi *confi,
+                 const gchar *prefix,
+                 ZakConfiWatchFunc func,
+                 gpointer user_data,
+                 GDestroyNotify notify)
+{
+	ZakConfiWatch *watch;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	g_return_val_if_fail (func != NULL, 0);
+
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			return 0;
+		}
+
+	watch = g_slice_new (ZakConfiWatch);
+	watch->prefix = zak_confi_path_normalize_prefix (confi, prefix);
+	watch->func = func;
+	watch->user_data = user_data;
+	watch->notify = notify;
+
+	return g_signal_connect_data (confi, "changed",
+	                              G_CALLBACK (zak_confi_watch_on_changed),
+	                              watch, zak_confi_watch_free, 0);
+}
+
+/**
+ * zak_confi_unwatch:
+ * @confi: a #ZakConfi object.
+ * @id: the id returned by zak_confi_watch().
+ *
+ */
+void
+zak_confi_unwatch (ZakConfi *confi, gulong id)
+{
+	g_signal_handler_disconnect (confi, id);
+}
+
+/**
+ * zak_confi_path_normalize:
+ * @pluggable: a #ZakConfiPluggable object.
+ *
+ * Returns: a normalize path (with root).
+ */
+gchar
+*zak_confi_path_normalize (ZakConfiPluggable *pluggable, const gchar *path)
+{
+	GString *ret;
+	gchar *strret;
+
+	guint lead;
+
+	gchar *root;
+
+	if (path == NULL)
+		{
+			return NULL;
+		}
+
+	ret = g_string_new (path);
+	g_strstrip (ret->str);
+	if (g_strcmp0 (ret->str, "") == 0)
+		{
+			return NULL;
+		}
+	else if (ret->str[strlen (ret->str) - 1] == '/')
+		{
+			return NULL;
+		}
+
+	/* removing leading '/' */
+	lead = 0;
+	for (lead = 0; lead < ret->len; lead++)
+		{
+			if (ret->str[lead] != '/')
+				{
+					break;
+				}
+		}
+
+	if (lead < ret->len)
+		{
+			g_string_erase (ret, 0, lead++);
+		}
+
+	g_object_get (pluggable, "root", &root, NULL);
+	g_string_prepend (ret, root);
+	g_free (root);
+
+	strret = g_strdup (ret->str);
+	g_string_free (ret, TRUE);
+
+	return strret;
+}
+
+/**
+ * zak_confi_new_async:
+ * @cnc_string: the connection string.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the object is created.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_new().
+ */
+void
+zak_confi_new_async (const gchar *cnc_string,
+                     GCancellable *cancellable,
+                     GAsyncReadyCallback callback,
+                     gpointer user_data)
+{
+	GTask *task;
+
+	g_return_if_fail (cnc_string != NULL);
+
+	task = zak_confi_async_new (NULL, ZAK_CONFI_ASYNC_NEW, cancellable, callback, user_data, zak_confi_new_async);
+	((ZakConfiAsyncData *)g_task_get_task_data (task))->path = g_strdup (cnc_string);
+	zak_confi_async_run (task);
+}
+
+/**
+ * zak_confi_new_finish:
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: (transfer none): the newly created #ZakConfi object, or NULL if it fails.
+ */
+ZakConfi
+*zak_confi_new_finish (GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, NULL), NULL);
+
+	return (ZakConfi *)g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/**
+ * zak_confi_get_configs_list_async:
+ * @cnc_string: the connection string to use to connect to database that
+ * contains configuration.
+ * @filter: (nullable):
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the list is read.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_get_configs_list().
+ */
+void
+zak_confi_get_configs_list_async (const gchar *cnc_string,
+                                  const gchar *filter,
+                                  GCancellable *cancellable,
+                                  GAsyncReadyCallback callback,
+                                  gpointer user_data)
+{
+	GTask *task;
+	ZakConfiAsyncData *data;
+
+	task = zak_confi_async_new (NULL, ZAK_CONFI_ASYNC_GET_CONFIGS_LIST, cancellable, callback, user_data, zak_confi_get_configs_list_async);
+	data = (ZakConfiAsyncData *)g_task_get_task_data (task);
+	data->path = g_strdup (cnc_string);
+	data->value = g_strdup (filter);
+	zak_confi_async_run (task);
+}
+
+/**
+ * zak_confi_get_configs_list_finish:
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: (element-type ZakConfi) (transfer container): see zak_confi_get_configs_list().
+ */
+GList
+*zak_confi_get_configs_list_finish (GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, NULL), NULL);
+
+	return (GList *)g_task_propagate_pointer (G_TASK (result), error);
+}
+
+static void
+zak_confi_get_tree_native_cb (GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	GTask *task = (GTask *)user_data;
+	GNode *tree;
+	GError *error;
+
+	error = NULL;
+	tree = zak_confi_pluggable_get_tree_finish ((ZakConfiPluggable *)source_object, res, &error);
+	if (error != NULL)
+		{
+			g_task_return_error (task, error);
+		}
+	else
+		{
+			g_task_return_pointer (task, tree, zak_confi_async_free_tree);
+		}
+	zak_confi_async_done (task);
+}
+
+/**
+ * zak_confi_get_tree_async:
+ * @confi: a #ZakConfi object.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the tree is read.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_get_tree().
+ */
+void
+zak_confi_get_tree_async (ZakConfi *confi,
+                          GCancellable *cancellable,
+                          GAsyncReadyCallback callback,
+                          gpointer user_data)
+{
+	GTask *task;
+	ZakConfiAsyncData *data;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	task = zak_confi_async_new (confi, ZAK_CONFI_ASYNC_GET_TREE, cancellable, callback, user_data, zak_confi_get_tree_async);
+	data = (ZakConfiAsyncData *)g_task_get_task_data (task);
+	data->native = (priv->pluggable != NULL
+	                && ZAK_CONFI_PLUGGABLE_GET_IFACE (priv->pluggable)->get_tree_async != NULL);
+	zak_confi_async_run (task);
+}
+
+/**
+ * zak_confi_get_tree_finish:
+ * @confi: a #ZakConfi object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: a #GNode.
+ */
+GNode
+*zak_confi_get_tree_finish (ZakConfi *confi, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, confi), NULL);
+
+	return (GNode *)g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/**
+ * zak_confi_snapshot_new_async:
+ * @confi: a #ZakConfi object.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the snapshot is ready.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_snapshot_new().
+ */
+void
+zak_confi_snapshot_new_async (ZakConfi *confi,
+                              GCancellable *cancellable,
+                              GAsyncReadyCallback callback,
+                              gpointer user_data)
+{
+	zak_confi_async_run (zak_confi_async_new (confi, ZAK_CONFI_ASYNC_SNAPSHOT_NEW, cancellable, callback, user_data, zak_confi_snapshot_new_async));
+}
+
+/**
+ * zak_confi_snapshot_new_finish:
+ * @confi: a #ZakConfi object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: (transfer full): a #ZakConfiSnapshot, or NULL if it fails.
+ */
+ZakConfiSnapshot
+*zak_confi_snapshot_new_finish (ZakConfi *confi, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, confi), NULL);
+
+	return (ZakConfiSnapshot *)g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/**
+ * zak_confi_add_key_async:
+ * @confi: a #ZakConfi object.
+ * @parent: the path where add the key.
+ * @key: the key's name.
+ * @value: the key's value.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the key is added.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_add_key().
+ */
+void
+zak_confi_add_key_async (ZakConfi *confi,
+                         const gchar *parent,
+                         const gchar *key,
+                         const gchar *value,
+                         GCancellable *cancellable,
+                         GAsyncReadyCallback callback,
+                         gpointer user_data)
+{
+	GTask *task;
+	ZakConfiAsyncData *data;
+
+	task = zak_confi_async_new (confi, ZAK_CONFI_ASYNC_ADD_KEY, cancellable, callback, user_data, zak_confi_add_key_async);
+	data = (ZakConfiAsyncData *)g_task_get_task_data (task);
+	data->path = g_strdup (parent);
+	data->key = g_strdup (key);
+	data->value = g_strdup (value);
+	zak_confi_async_run (task);
+}
+
+/**
+ * zak_confi_add_key_finish:
+ * @confi: a #ZakConfi object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: a #ZakConfigKey struct filled with data from the key just added.
+ */
+ZakConfiKey
+*zak_confi_add_key_finish (ZakConfi *confi, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, confi), NULL);
+
+	return (ZakConfiKey *)g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/**
+ * zak_confi_key_set_key_async:
+ * @confi: a #ZakConfi object.
+ * @ck: a #ZakConfiKey struct; it is copied.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the key is written.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_key_set_key().
+ */
+void
+zak_confi_key_set_key_async (ZakConfi *confi,
+                             ZakConfiKey *ck,
+                             GCancellable *cancellable,
+                             GAsyncReadyCallback callback,
+                             gpointer user_data)
+{
+	GTask *task;
+
+	task = zak_confi_async_new (confi, ZAK_CONFI_ASYNC_KEY_SET_KEY, cancellable, callback, user_data, zak_confi_key_set_key_async);
+	((ZakConfiAsyncData *)g_task_get_task_data (task))->ck = zak_confi_key_copy (ck);
+	zak_confi_async_run (task);
+}
+
+/**
+ * zak_confi_key_set_key_finish:
+ * @confi: a #ZakConfi object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_key_set_key_finish (ZakConfi *confi, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, confi), FALSE);
+
+	return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * zak_confi_remove_path_async:
+ * @confi: a #ZakConfi object.
+ * @path: the path to remove.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the path is removed.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_remove_path().
+ */
+void
+zak_confi_remove_path_async (ZakConfi *confi,
+                             const gchar *path,
+                             GCancellable *cancellable,
+                             GAsyncReadyCallback callback,
+                             gpointer user_data)
+{
+	GTask *task;
+
+	task = zak_confi_async_new (confi, ZAK_CONFI_ASYNC_REMOVE_PATH, cancellable, callback, user_data, zak_confi_remove_path_async);
+	((ZakConfiAsyncData *)g_task_get_task_data (task))->path = g_strdup (path);
+	zak_confi_async_run (task);
+}
+
+/**
+ * zak_confi_remove_path_finish:
+ * @confi: a #ZakConfi object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_remove_path_finish (ZakConfi *confi, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, confi), FALSE);
+
+	return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+static void
+zak_confi_path_get_value_native_cb (GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	GTask *task = (GTask *)user_data;
+	ZakConfiAsyncData *data;
+	gchar *value;
+	GError *error;
+
+	data = (ZakConfiAsyncData *)g_task_get_task_data (task);
+
+	error = NULL;
+	value = zak_confi_pluggable_path_get_value_finish ((ZakConfiPluggable *)source_object, res, &error);
+	if (error != NULL)
+		{
+			g_task_return_error (task, error);
+		}
+	else
+		{
+			if (value != NULL && data->key != NULL)
+				{
+					zak_confi_cache_insert ((ZakConfi *)g_task_get_source_object (task), data->key, value);
+				}
+			g_task_return_pointer (task, value, g_free);
+		}
+	zak_confi_async_done (task);
+}
+
+/**
+ * zak_confi_path_get_value_async:
+ * @confi: a #ZakConfi object.
+ * @path: the path from which retrieving the value.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the value is read.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_path_get_value().
+ */
+void
+zak_confi_path_get_value_async (ZakConfi *confi,
+                                const gchar *path,
+                                GCancellable *cancellable,
+                                GAsyncReadyCallback callback,
+                                gpointer user_data)
+{
+	GTask *task;
+	ZakConfiAsyncData *data;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	task = zak_confi_async_new (confi, ZAK_CONFI_ASYNC_PATH_GET_VALUE, cancellable, callback, user_data, zak_confi_path_get_value_async);
+	data = (ZakConfiAsyncData *)g_task_get_task_data (task);
+	data->path = g_strdup (path);
+	data->native = (priv->pluggable != NULL
+	                && ZAK_CONFI_PLUGGABLE_GET_IFACE (priv->pluggable)->path_get_value_async != NULL);
+	zak_confi_async_run (task);
+}
+
+/**
+ * zak_confi_path_get_value_finish:
+ * @confi: a #ZakConfi object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: the configuration's value as a string.
+ */
+gchar
+*zak_confi_path_get_value_finish (ZakConfi *confi, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, confi), NULL);
+
+	return (gchar *)g_task_propagate_pointer (G_TASK (result), error);
+}
+
+static void
+zak_confi_paths_get_values_native_cb (GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	GTask *task = (GTask *)user_data;
+	ZakConfiAsyncData *data;
+	GHashTable *values;
+	GError *error;
+
+	data = (ZakConfiAsyncData *)g_task_get_task_data (task);
+
+	error = NULL;
+	values = zak_confi_pluggable_paths_get_values_finish ((ZakConfiPluggable *)source_object, res, &error);
+	if (error != NULL)
+		{
+			g_task_return_error (task, error);
+		}
+	else
+		{
+			zak_confi_paths_add_values ((ZakConfi *)g_task_get_source_object (task), data->values, values);
+			g_task_return_pointer (task, g_hash_table_ref (data->values), (GDestroyNotify)g_hash_table_unref);
+		}
+	zak_confi_async_done (task);
+}
+
+/**
+ * zak_confi_paths_get_values_async:
+ * @confi: a #ZakConfi object.
+ * @paths: (array zero-terminated=1): the paths from which retrieving the values.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the values are read.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_paths_get_values().
+ */
+void
+zak_confi_paths_get_values_async (ZakConfi *confi,
+                                  const gchar **paths,
+                                  GCancellable *cancellable,
+                                  GAsyncReadyCallback callback,
+                                  gpointer user_data)
+{
+	GTask *task;
+	ZakConfiAsyncData *data;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	task = zak_confi_async_new (confi, ZAK_CONFI_ASYNC_PATHS_GET_VALUES, cancellable, callback, user_data, zak_confi_paths_get_values_async);
+	data = (ZakConfiAsyncData *)g_task_get_task_data (task);
+	data->paths = g_strdupv ((gchar **)paths);
+	data->native = (priv->pluggable != NULL
+	                && ZAK_CONFI_PLUGGABLE_GET_IFACE (priv->pluggable)->paths_get_values_async != NULL);
+	zak_confi_async_run (task);
+}
+
+/**
+ * zak_confi_paths_get_values_finish:
+ * @confi: a #ZakConfi object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: (transfer full) (element-type utf8 utf8): see zak_confi_paths_get_values().
+ */
+GHashTable
+*zak_confi_paths_get_values_finish (ZakConfi *confi, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, confi), NULL);
+
+	return (GHashTable *)g_task_propagate_pointer (G_TASK (result), error);
+}
+
+static void
+zak_confi_path_set_value_native_cb (GObject *source_object, GAsyncResult *res, gpointer user_data)
+{
+	GTask *task = (GTask *)user_data;
+	ZakConfiAsyncData *data;
+	gboolean ret;
+	GError *error;
+
+	data = (ZakConfiAsyncData *)g_task_get_task_data (task);
+
+	error = NULL;
+	ret = zak_confi_pluggable_path_set_value_finish ((ZakConfiPluggable *)source_object, res, &error);
+	if (error != NULL)
+		{
+			g_task_return_error (task, error);
+		}
+	else
+		{
+			if (ret)
+				{
+					zak_confi_path_set_value_done ((ZakConfi *)g_task_get_source_object (task), data->path);
+				}
+			g_task_return_boolean (task, ret);
+		}
+	zak_confi_async_done (task);
+}
+
+/**
+ * zak_confi_path_set_value_async:
+ * @confi: a #ZakConfi object.
+ * @path: the key's path.
+ * @value: the value to set.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the value is written.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_path_set_value().
+ */
+void
+zak_confi_path_set_value_async (ZakConfi *confi,
+                                const gchar *path,
+                                const gchar *value,
+                                GCancellable *cancellable,
+                                GAsyncReadyCallback callback,
+                                gpointer user_data)
+{
+	GTask *task;
+	ZakConfiAsyncData *data;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	task = zak_confi_async_new (confi, ZAK_CONFI_ASYNC_PATH_SET_VALUE, cancellable, callback, user_data, zak_confi_path_set_value_async);
+	data = (ZakConfiAsyncData *)g_task_get_task_data (task);
+	data->path = g_strdup (path);
+	data->value = g_strdup (value);
+	data->native = (priv->pluggable != NULL
+	                && ZAK_CONFI_PLUGGABLE_GET_IFACE (priv->pluggable)->path_set_value_async != NULL);
+	zak_confi_async_run (task);
+}
+
+/**
+ * zak_confi_path_set_value_finish:
+ * @confi: a #ZakConfi object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_path_set_value_finish (ZakConfi *confi, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, confi), FALSE);
+
+	return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * zak_confi_path_get_confi_key_async:
+ * @confi: a #ZakConfi object.
+ * @path: the key's path to get.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the key is read.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_path_get_confi_key().
+ */
+void
+zak_confi_path_get_confi_key_async (ZakConfi *confi,
+                                    const gchar *path,
+                                    GCancellable *cancellable,
+                                    GAsyncReadyCallback callback,
+                                    gpointer user_data)
+{
+	GTask *task;
+
+	task = zak_confi_async_new (confi, ZAK_CONFI_ASYNC_PATH_GET_CONFI_KEY, cancellable, callback, user_data, zak_confi_path_get_confi_key_async);
+	((ZakConfiAsyncData *)g_task_get_task_data (task))->path = g_strdup (path);
+	zak_confi_async_run (task);
+}
+
+/**
+ * zak_confi_path_get_confi_key_finish:
+ * @confi: a #ZakConfi object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: (transfer full): a #ZakConfiKey.
+ */
+ZakConfiKey
+*zak_confi_path_get_confi_key_finish (ZakConfi *confi, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, confi), NULL);
+
+	return (ZakConfiKey *)g_task_propagate_pointer (G_TASK (result), error);
+}
+
+/**
+ * zak_confi_begin_async:
+ * @confi: a #ZakConfi object.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the transaction is started.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_begin().
+ */
+void
+zak_confi_begin_async (ZakConfi *confi,
+                       GCancellable *cancellable,
+                       GAsyncReadyCallback callback,
+                       gpointer user_data)
+{
+	zak_confi_async_run (zak_confi_async_new (confi, ZAK_CONFI_ASYNC_BEGIN, cancellable, callback, user_data, zak_confi_begin_async));
+}
+
+/**
+ * zak_confi_begin_finish:
+ * @confi: a #ZakConfi object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_begin_finish (ZakConfi *confi, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, confi), FALSE);
+
+	return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * zak_confi_commit_async:
+ * @confi: a #ZakConfi object.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the changes are written.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_commit().
+ */
+void
+zak_confi_commit_async (ZakConfi *confi,
+                        GCancellable *cancellable,
+                        GAsyncReadyCallback callback,
+                        gpointer user_data)
+{
+	zak_confi_async_run (zak_confi_async_new (confi, ZAK_CONFI_ASYNC_COMMIT, cancellable, callback, user_data, zak_confi_commit_async));
+}
+
+/**
+ * zak_confi_commit_finish:
+ * @confi: a #ZakConfi object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_commit_finish (ZakConfi *confi, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, confi), FALSE);
+
+	return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * zak_confi_rollback_async:
+ * @confi: a #ZakConfi object.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the changes are discarded.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_rollback().
+ */
+void
+zak_confi_rollback_async (ZakConfi *confi,
+                          GCancellable *cancellable,
+                          GAsyncReadyCallback callback,
+                          gpointer user_data)
+{
+	zak_confi_async_run (zak_confi_async_new (confi, ZAK_CONFI_ASYNC_ROLLBACK, cancellable, callback, user_data, zak_confi_rollback_async));
+}
+
+/**
+ * zak_confi_rollback_finish:
+ * @confi: a #ZakConfi object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_rollback_finish (ZakConfi *confi, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, confi), FALSE);
+
+	return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * zak_confi_flush_async:
+ * @confi: a #ZakConfi object.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the changes are written.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_flush().
+ */
+void
+zak_confi_flush_async (ZakConfi *confi,
+                       GCancellable *cancellable,
+                       GAsyncReadyCallback callback,
+                       gpointer user_data)
+{
+	zak_confi_async_run (zak_confi_async_new (confi, ZAK_CONFI_ASYNC_FLUSH, cancellable, callback, user_data, zak_confi_flush_async));
+}
+
+/**
+ * zak_confi_flush_finish:
+ * @confi: a #ZakConfi object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_flush_finish (ZakConfi *confi, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, confi), FALSE);
+
+	return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/**
+ * zak_confi_remove_async:
+ * @confi: a #ZakConfi object.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the configuration is removed.
+ * @user_data: data for @callback.
+ *
+ * Asynchronous version of zak_confi_remove().
+ */
+void
+zak_confi_remove_async (ZakConfi *confi,
+                        GCancellable *cancellable,
+                        GAsyncReadyCallback callback,
+                        gpointer user_data)
+{
+	zak_confi_async_run (zak_confi_async_new (confi, ZAK_CONFI_ASYNC_REMOVE, cancellable, callback, user_data, zak_confi_remove_async));
+}
+
+/**
+ * zak_confi_remove_finish:
+ * @confi: a #ZakConfi object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_remove_finish (ZakConfi *confi, GAsyncResult *result, GError **error)
+{
+	g_return_val_if_fail (g_task_is_valid (result, confi), FALSE);
+
+	return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+/* PRIVATE */
+static void
+zak_confi_set_property (GObject *object, guint property_id, const GValue *value, GParamSpec *pspec)
+{
+	gchar *sql;
+
+	ZakConfi *confi = ZAK_CONFI (object);
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	switch (property_id)
+		{
+			default:
+				G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+				break;
+		}
+}
+
+static void
+zak_confi_get_property (GObject *object, guint property_id, GValue *value, GParamSpec *pspec)
+{
+	ZakConfi *confi = ZAK_CONFI (object);
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	switch (property_id)
+		{
+			default:
+				G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+				break;
+		}
+}
+
+static void
+zak_confi_cache_entry_free (gpointer data)
+{
+	ZakConfiCacheEntry *entry = (ZakConfiCacheEntry *)data;
+
+	g_free (entry->path);
+	g_free (entry->value);
+	g_strfreev (entry->parsed_value.v_strv);
+	g_slice_free (ZakConfiCacheEntry, entry);
+}
+
+/* returns a copy of the cached value of the normalized @path, updating
+ * the lru list and the counters */
+static gchar
+*zak_confi_cache_get (ZakConfi *confi, const gchar *path)
+{
+	ZakConfiCacheEntry *entry;
+	gchar *ret;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	ret = NULL;
+
+	g_mutex_lock (&priv->cache_lock);
+
+	entry = (priv->values != NULL ? (ZakConfiCacheEntry *)g_hash_table_lookup (priv->values, path) : NULL);
+	if (entry != NULL)
+		{
+			priv->cache_hits++;
+
+			/* moving to the head of the lru list */
+			g_queue_unlink (&priv->lru, entry->link);
+			g_queue_push_head_link (&priv->lru, entry->link);
+
+			ret = g_strdup (entry->value);
+		}
+	else
+		{
+			priv->cache_misses++;
+		}
+
+	g_mutex_unlock (&priv->cache_lock);
+
+	return ret;
+}
+
+/* returns the value of @path, from the cache if enabled */
+static gchar
+*zak_confi_cache_lookup (ZakConfi *confi, const gchar *path)
+{
+	return zak_confi_cache_lookup_full (confi, path, FALSE);
+}
+
+/* with @quiet a missing key isn't logged by the plugin; the missing
+ * paths go in the negative cache, with the whole branch if the plugin
+ * tells which one is missing */
+static gchar
+*zak_confi_cache_lookup_full (ZakConfi *confi, const gchar *path, gboolean quiet)
+{
+	gchar *path_;
+	gchar *absent;
+	gchar *ret;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->cache_size == 0)
+		{
+			return (quiet
+			        ? zak_confi_pluggable_path_lookup_value (priv->pluggable, path, NULL)
+			        : zak_confi_pluggable_path_get_value (priv->pluggable, path));
+		}
+
+	path_ = zak_confi_path_normalize (priv->pluggable, path);
+	if (path_ == NULL)
+		{
+			return NULL;
+		}
+
+	if (zak_confi_absent_contains (confi, path_))
+		{
+			g_free (path_);
+			return NULL;
+		}
+
+	ret = zak_confi_cache_get (confi, path_);
+	if (ret == NULL)
+		{
+			absent = NULL;
+			if (quiet)
+				{
+					ret = zak_confi_pluggable_path_lookup_value (priv->pluggable, path, &absent);
+				}
+			else
+				{
+					ret = zak_confi_pluggable_path_get_value (priv->pluggable, path);
+				}
+
+			if (ret != NULL)
+				{
+					zak_confi_cache_insert (confi, path_, ret);
+				}
+			else if (absent != NULL)
+				{
+					zak_confi_absent_insert (confi, absent, TRUE);
+				}
+			else
+				{
+					/* e.g. a group of a file isn't a key, but its keys exist */
+					zak_confi_absent_insert (confi, g_strdup (path_), FALSE);
+				}
+		}
+	g_free (path_);
+
+	return ret;
+}
+
+/* parses @value as @type into @parsed; @parsed->v_strv is newly allocated */
+static gboolean
+zak_confi_value_parse (const gchar *value, ZakConfiParsedType type, ZakConfiParsedValue *parsed)
+{
+	gchar *end;
+	gchar *value_;
+	gint64 v_int;
+	guint len;
+	gboolean ok;
+
+	if (value == NULL)
+		{
+			return FALSE;
+		}
+
+	switch (type)
+		{
+			case ZAK_CONFI_PARSED_INT:
+				value_ = g_strstrip (g_strdup (value));
+				v_int = g_ascii_strtoll (value_, &end, 10);
+				parsed->v_int = (gint)v_int;
+				ok = (value_[0] != '\0' && *end == '\0' && v_int >= G_MININT && v_int <= G_MAXINT);
+				g_free (value_);
+				return ok;
+
+			case ZAK_CONFI_PARSED_BOOLEAN:
+				value_ = g_strstrip (g_strdup (value));
+				if (g_ascii_strcasecmp (value_, "true") == 0
+				    || g_ascii_strcasecmp (value_, "yes") == 0
+				    || g_strcmp0 (value_, "1") == 0)
+					{
+						parsed->v_boolean = TRUE;
+					}
+				else if (g_ascii_strcasecmp (value_, "false") == 0
+				         || g_ascii_strcasecmp (value_, "no") == 0
+				         || g_strcmp0 (value_, "0") == 0)
+					{
+						parsed->v_boolean = FALSE;
+					}
+				else
+					{
+						g_free (value_);
+						return FALSE;
+					}
+				g_free (value_);
+				return TRUE;
+
+			case ZAK_CONFI_PARSED_DOUBLE:
+				value_ = g_strstrip (g_strdup (value));
+				parsed->v_double = g_ascii_strtod (value_, &end);
+				ok = (value_[0] != '\0' && *end == '\0');
+				g_free (value_);
+				return ok;
+
+			case ZAK_CONFI_PARSED_STRV:
+				/* a trailing separator doesn't add an empty item */
+				len = strlen (value);
+				value_ = g_strndup (value, (len > 0 && value[len - 1] == ';' ? len - 1 : len));
+				parsed->v_strv = (value_[0] != '\0' ? g_strsplit (value_, ";", -1) : g_new0 (gchar *, 1));
+				g_free (value_);
+				return TRUE;
+		}
+
+	return FALSE;
+}
+
+/* as zak_confi_cache_lookup(), returning the value parsed as @type; the
+ * parsed value is kept in the cache entry, so only the first typed read
+ * of a cached value parses it */
+static gboolean
+zak_confi_cache_lookup_parsed (ZakConfi *confi, const gchar *path, ZakConfiParsedType type, ZakConfiParsedValue *parsed)
+{
+	ZakConfiCacheEntry *entry;
+	gboolean ret;
+	gchar *path_;
+	gchar *value;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->pluggable == NULL)
+		{
+			g_warning ("Not initialized.");
+			return FALSE;
+		}
+
+	memset (parsed, 0, sizeof (ZakConfiParsedValue));
+
+	if (priv->cache_size > 0)
+		{
+			path_ = zak_confi_path_normalize (priv->pluggable, path);
+			if (path_ == NULL)
+				{
+					return FALSE;
+				}
+
+			if (zak_confi_absent_contains (confi, path_))
+				{
+					g_free (path_);
+					return FALSE;
+				}
+
+			g_mutex_lock (&priv->cache_lock);
+			entry = (priv->values != NULL ? (ZakConfiCacheEntry *)g_hash_table_lookup (priv->values, path_) : NULL);
+			if (entry != NULL)
+				{
+					priv->cache_hits++;
+					g_queue_unlink (&priv->lru, entry->link);
+					g_queue_push_head_link (&priv->lru, entry->link);
+
+					if ((entry->parsed & type) == 0)
+						{
+							if (zak_confi_value_parse (entry->value, type, &entry->parsed_value))
+								{
+									entry->valid |= type;
+								}
+							entry->parsed |= type;
+						}
+
+					ret = ((entry->valid & type) != 0);
+					if (ret)
+						{
+							*parsed = entry->parsed_value;
+							parsed->v_strv = (type == ZAK_CONFI_PARSED_STRV ? g_strdupv (entry->parsed_value.v_strv) : NULL);
+						}
+
+					g_mutex_unlock (&priv->cache_lock);
+					g_free (path_);
+					return ret;
+				}
+			g_mutex_unlock (&priv->cache_lock);
+			g_free (path_);
+		}
+
+	/* reading it also puts it in the cache, for the next time */
+	value = zak_confi_cache_lookup_full (confi, path, TRUE);
+	ret = zak_confi_value_parse (value, type, parsed);
+	g_free (value);
+
+	return ret;
+}
+
+/* TRUE if the normalized @path is known to be missing, or is in a
+ * missing branch */
+static gboolean
+zak_confi_absent_contains (ZakConfi *confi, const gchar *path)
+{
+	gboolean ret;
+	gchar *path_;
+	gchar *slash;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	g_mutex_lock (&priv->cache_lock);
+
+	ret = (priv->absent != NULL && g_hash_table_contains (priv->absent, path));
+
+	if (!ret
+	    && priv->absent_branches != NULL
+	    && g_hash_table_size (priv->absent_branches) > 0)
+		{
+			path_ = g_strdup (path);
+			for (;;)
+				{
+					if (g_hash_table_contains (priv->absent_branches, path_))
+						{
+							ret = TRUE;
+							break;
+						}
+
+					slash = strrchr (path_, '/');
+					if (slash == NULL || slash == path_)
+						{
+							break;
+						}
+					*slash = '\0';
+				}
+			g_free (path_);
+		}
+
+	g_mutex_unlock (&priv->cache_lock);
+
+	return ret;
+}
+
+/* takes the ownership of @path; with @branch the paths below it are
+ * missing too */
+static void
+zak_confi_absent_insert (ZakConfi *confi, gchar *path, gboolean branch)
+{
+	GHashTable **absent;
+	GQueue *fifo;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (path == NULL)
+		{
+			return;
+		}
+
+	g_mutex_lock (&priv->cache_lock);
+
+	if (priv->cache_size == 0)
+		{
+			g_mutex_unlock (&priv->cache_lock);
+			g_free (path);
+			return;
+		}
+
+	absent = (branch ? &priv->absent_branches : &priv->absent);
+	fifo = (branch ? &priv->absent_branches_fifo : &priv->absent_fifo);
+
+	if (*absent == NULL)
+		{
+			*absent = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+		}
+	if (g_hash_table_contains (*absent, path))
+		{
+			g_mutex_unlock (&priv->cache_lock);
+			g_free (path);
+			return;
+		}
+
+	while (fifo->length >= priv->cache_size)
+		{
+			g_hash_table_remove (*absent, g_queue_pop_tail (fifo));
+		}
+
+	g_hash_table_add (*absent, path);
+	g_queue_push_head (fifo, path);
+
+	g_mutex_unlock (&priv->cache_lock);
+}
+
+/* must be called with cache_lock locked */
+static void
+zak_confi_absent_remove_one (GHashTable *absent, GQueue *fifo, const gchar *path)
+{
+	gpointer key;
+
+	if (absent != NULL
+	    && g_hash_table_lookup_extended (absent, path, &key, NULL))
+		{
+			g_queue_remove (fifo, key);
+			g_hash_table_remove (absent, path);
+		}
+}
+
+/* forgets the normalized @path and its parents, when @path is added */
+static void
+zak_confi_absent_remove_ancestors (ZakConfi *confi, const gchar *path)
+{
+	gchar *path_;
+	gchar *slash;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	g_mutex_lock (&priv->cache_lock);
+
+	path_ = g_strdup (path);
+	for (;;)
+		{
+			zak_confi_absent_remove_one (priv->absent, &priv->absent_fifo, path_);
+			zak_confi_absent_remove_one (priv->absent_branches, &priv->absent_branches_fifo, path_);
+
+			slash = strrchr (path_, '/');
+			if (slash == NULL || slash == path_)
+				{
+					break;
+				}
+			*slash = '\0';
+		}
+	g_free (path_);
+
+	g_mutex_unlock (&priv->cache_lock);
+}
+
+static void
+zak_confi_absent_clear (ZakConfi *confi)
+{
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	g_mutex_lock (&priv->cache_lock);
+
+	if (priv->absent != NULL)
+		{
+			g_hash_table_remove_all (priv->absent);
+		}
+	g_queue_clear (&priv->absent_fifo);
+	if (priv->absent_branches != NULL)
+		{
+			g_hash_table_remove_all (priv->absent_branches);
+		}
+	g_queue_clear (&priv->absent_branches_fifo);
+
+	g_mutex_unlock (&priv->cache_lock);
+}
+
+static void
+zak_confi_cache_insert (ZakConfi *confi, const gchar *path, const gchar *value)
+{
+	ZakConfiCacheEntry *entry;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	g_mutex_lock (&priv->cache_lock);
+
+	if (priv->values == NULL)
+		{
+			g_mutex_unlock (&priv->cache_lock);
+			return;
+		}
+
+	/* the same path can be read twice at once (e.g. by an async worker
+	 * and the caller's thread): updating the entry in place keeps the
+	 * table key and the lru link valid */
+	entry = (ZakConfiCacheEntry *)g_hash_table_lookup (priv->values, path);
+	if (entry != NULL)
+		{
+			g_free (entry->value);
+			entry->value = g_strdup (value);
+			g_strfreev (entry->parsed_value.v_strv);
+			memset (&entry->parsed_value, 0, sizeof (ZakConfiParsedValue));
+			entry->parsed = 0;
+			entry->valid = 0;
+
+			g_queue_unlink (&priv->lru, entry->link);
+			g_queue_push_head_link (&priv->lru, entry->link);
+
+			g_mutex_unlock (&priv->cache_lock);
+			return;
+		}
+
+	while (priv->lru.length >= priv->cache_size)
+		{
+			entry = (ZakConfiCacheEntry *)g_queue_pop_tail (&priv->lru);
+			g_hash_table_remove (priv->values, entry->path);
+		}
+
+	entry = g_slice_new0 (ZakConfiCacheEntry);
+	entry->path = g_strdup (path);
+	entry->value = g_strdup (value);
+	g_queue_push_head (&priv->lru, entry);
+	entry->link = priv->lru.head;
+
+	g_hash_table_insert (priv->values, entry->path, entry);
+
+	g_mutex_unlock (&priv->cache_lock);
+}
+
+/* removes from the cache @prefix and every path below it; every value
+ * if @prefix is NULL or empty */
+static void
+zak_confi_cache_remove_prefix (ZakConfi *confi, const gchar *prefix)
+{
+	gchar *prefix_;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (priv->cache_size == 0)
+		{
+			return;
+		}
+
+	prefix_ = zak_confi_path_normalize (priv->pluggable, prefix);
+	zak_confi_cache_remove_normalized (confi, prefix_);
+	g_free (prefix_);
+}
+
+/* as zak_confi_cache_remove_prefix(), with @prefix already normalized */
+static void
+zak_confi_cache_remove_normalized (ZakConfi *confi, const gchar *prefix)
+{
+	GHashTableIter iter;
+	ZakConfiCacheEntry *entry;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	g_mutex_lock (&priv->cache_lock);
+
+	if (priv->values == NULL)
+		{
+			g_mutex_unlock (&priv->cache_lock);
+			return;
+		}
+
+	if (prefix == NULL)
+		{
+			g_hash_table_remove_all (priv->values);
+			g_queue_clear (&priv->lru);
+			g_mutex_unlock (&priv->cache_lock);
+			return;
+		}
+
+	g_hash_table_iter_init (&iter, priv->values);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&entry))
+		{
+			if (zak_confi_path_is_below (entry->path, prefix))
+				{
+					g_queue_delete_link (&priv->lru, entry->link);
+					g_hash_table_iter_remove (&iter);
+				}
+		}
+
+	g_mutex_unlock (&priv->cache_lock);
+}
+
+/* returns @path normalized, also if it ends with '/'; NULL or empty @path
+ * is the root */
+static gchar
+*zak_confi_path_normalize_prefix (ZakConfi *confi, const gchar *path)
+{
+	gchar *path_;
+	gchar *ret;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	path_ = g_strstrip (g_strdup (path != NULL ? path : ""));
+	while (path_[0] != '\0' && path_[strlen (path_) - 1] == '/')
+		{
+			path_[strlen (path_) - 1] = '\0';
+		}
+
+	if (path_[0] != '\0')
+		{
+			ret = zak_confi_path_normalize (priv->pluggable, path_);
+		}
+	else
+		{
+			g_object_get (priv->pluggable, "root", &ret, NULL);
+			if (ret != NULL && strlen (ret) > 1 && ret[strlen (ret) - 1] == '/')
+				{
+					ret[strlen (ret) - 1] = '\0';
+				}
+		}
+	g_free (path_);
+
+	return ret;
+}
+
+/* TRUE if @path is @prefix or a key below it */
+static gboolean
+zak_confi_path_is_below (const gchar *path, const gchar *prefix)
+{
+	gsize len;
+
+	len = strlen (prefix);
+
+	return (strncmp (path, prefix, len) == 0
+	        && (path[len] == '\0'
+	            || path[len] == '/'
+	            || (len > 0 && prefix[len - 1] == '/')));
+}
+
+/* invalidates the cache for @path (relative to the root; NULL for the
+ * whole configuration) and emits ZakConfi::changed */
+static void
+zak_confi_changed (ZakConfi *confi, const gchar *path)
+{
+	gchar *path_;
+
+	if (path == NULL)
+		{
+			zak_confi_cache_remove_normalized (confi, NULL);
+		}
+	else
+		{
+			zak_confi_cache_remove_prefix (confi, path);
+		}
+
+	path_ = zak_confi_path_normalize_prefix (confi, path);
+	if (path_ != NULL)
+		{
+			zak_confi_emit_changed (confi, path_);
+			g_free (path_);
+		}
+}
+
+/* after a successful write of @path: the plugin could have created the
+ * key, so it's no more missing */
+static void
+zak_confi_path_set_value_done (ZakConfi *confi, const gchar *path)
+{
+	gchar *path_;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	path_ = zak_confi_path_normalize (priv->pluggable, path);
+	if (path_ != NULL)
+		{
+			zak_confi_absent_remove_ancestors (confi, path_);
+			g_free (path_);
+		}
+	zak_confi_changed (confi, path);
+}
+
+/* a change made outside this ZakConfi, with @path already normalized */
+static void
+zak_confi_on_pluggable_changed (ZakConfiPluggable *pluggable, const gchar *path, gpointer user_data)
+{
+	ZakConfi *confi = (ZakConfi *)user_data;
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	/* keys could be added, removed or renamed too: the handles
+	 * resolve their ids again */
+	g_atomic_int_inc (&priv->serial);
+	zak_confi_absent_clear (confi);
+	zak_confi_cache_remove_normalized (confi, (path != NULL && g_strcmp0 (path, "/") != 0 ? path : NULL));
+	zak_confi_emit_changed (confi, (path != NULL ? path : "/"));
+}
+
+typedef struct
+	{
+		ZakConfi *confi;
+		gchar *path;
+	} ZakConfiChanged;
+
+static gboolean
+zak_confi_emit_changed_cb (gpointer user_data)
+{
+	ZakConfiChanged *changed = (ZakConfiChanged *)user_data;
+
+	g_signal_emit (changed->confi, zak_confi_signals[SIGNAL_CHANGED], g_quark_try_string (changed->path), changed->path);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+zak_confi_changed_free (gpointer user_data)
+{
+	ZakConfiChanged *changed = (ZakConfiChanged *)user_data;
+
+	g_object_unref (changed->confi);
+	g_free (changed->path);
+	g_slice_free (ZakConfiChanged, changed);
+}
+
+/* emits "changed" for the normalized @path; from a worker thread, in the
+ * context of the asynchronous operation running */
+static void
+zak_confi_emit_changed (ZakConfi *confi, const gchar *path)
+{
+	GMainContext *context;
+	ZakConfiChanged *changed;
+
+	context = (GMainContext *)g_private_get (&async_context);
+	if (context == NULL)
+		{
+			g_signal_emit (confi, zak_confi_signals[SIGNAL_CHANGED], g_quark_try_string (path), path);
+			return;
+		}
+
+	changed = g_slice_new (ZakConfiChanged);
+	changed->confi = g_object_ref (confi);
+	changed->path = g_strdup (path);
+	g_main_context_invoke_full (context, G_PRIORITY_DEFAULT, zak_confi_emit_changed_cb, changed, zak_confi_changed_free);
+}
+
+/* puts in @ret the values of @paths found in cache, and returns the
+ * paths not found; the ones known to be missing are skipped */
+static GPtrArray
+*zak_confi_paths_get_cached (ZakConfi *confi, const gchar **paths, GHashTable *ret)
+{
+	GPtrArray *missing;
+	gchar *path_;
+	gchar *value;
+	guint i;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	missing = g_ptr_array_new ();
+	for (i = 0; paths != NULL && paths[i] != NULL; i++)
+		{
+			value = NULL;
+			if (priv->cache_size > 0)
+				{
+					path_ = zak_confi_path_normalize (priv->pluggable, paths[i]);
+					if (path_ != NULL)
+						{
+							if (zak_confi_absent_contains (confi, path_))
+								{
+									g_free (path_);
+									continue;
+								}
+							value = zak_confi_cache_get (confi, path_);
+							g_free (path_);
+						}
+				}
+
+			if (value != NULL)
+				{
+					g_hash_table_replace (ret, g_strdup (paths[i]), value);
+				}
+			else
+				{
+					g_ptr_array_add (missing, (gpointer)paths[i]);
+				}
+		}
+
+	return missing;
+}
+
+/* moves into @ret, and in cache, the @values read from the backend;
+ * @values is destroyed */
+static void
+zak_confi_paths_add_values (ZakConfi *confi, GHashTable *ret, GHashTable *values)
+{
+	GHashTableIter iter;
+	gchar *path_;
+	gchar *path;
+	gchar *value;
+
+	ZakConfiPrivate *priv = ZAK_CONFI_GET_PRIVATE (confi);
+
+	if (values == NULL)
+		{
+			return;
+		}
+
+	g_hash_table_iter_init (&iter, values);
+	while (g_hash_table_iter_next (&iter, (gpointer *)&path, (gpointer *)&value))
+		{
+			if (priv->cache_size > 0)
+				{
+					path_ = zak_confi_path_normalize (priv->pluggable, path);
+					if (path_ != NULL)
+						{
+							zak_confi_cache_insert (confi, path_, value);
+							g_free (path_);
+						}
+				}
+			g_hash_table_iter_steal (&iter);
+			g_hash_table_replace (ret, path, value);
+		}
+	g_hash_table_destroy (values);
+}
+
+static void
+zak_confi_async_free_tree (gpointer data)
+{
+	GNode *tree = (GNode *)data;
+
+	zak_confi_free_tree (tree);
+}
+
+/* the keys returned by the plugins are allocated with g_new0 */
+static void
+zak_confi_async_free_key (gpointer data)
+{
+	ZakConfiKey *ck = (ZakConfiKey *)data;
+
+	g_free (ck->key);
+	g_free (ck->value);
+	g_free (ck->description);
+	g_free (ck->path);
+	g_free (ck);
+}
+
+static void
+zak_confi_async_free_configs_list (gpointer data)
+{
+	GList *lst;
+
+	for (lst = (GList *)data; lst != NULL; lst = g_list_next (lst))
+		{
+			ZakConfiConfi *confi = (ZakConfiConfi *)lst->data;
+			if (confi != NULL)
+				{
+					g_free (confi->name);
+					g_free (confi->description);
+					g_free (confi);
+				}
+		}
+	g_list_free ((GList *)data);
+}
+
+static void
+zak_confi_async_free_confi (gpointer data)
+{
+	zak_confi_destroy ((ZakConfi *)data);
+	g_object_unref (data);
+}
+
+static void
+zak_confi_async_data_free (gpointer data)
+{
+	ZakConfiAsyncData *adata = (ZakConfiAsyncData *)data;
+
+	g_free (adata->path);
+	g_free (adata->key);
+	g_free (adata->value);
+	g_strfreev (adata->paths);
+	if (adata->ck != NULL)
+		{
+			zak_confi_key_free (adata->ck);
+		}
+	if (adata->values != NULL)
+		{
+			g_hash_table_unref (adata->values);
+		}
+	g_slice_free (ZakConfiAsyncData, adata);
+}
+
+static GTask
+*zak_confi_async_new (gpointer source_object,
+                      ZakConfiAsyncOp op,
+                      GCancellable *cancellable,
+                      GAsyncReadyCallback callback,
+                      gpointer user_data,
+                      gpointer source_tag)
+{
+	GTask *task;
+	ZakConfiAsyncData *data;
+
+	task = g_task_new (source_object, cancellable, callback, user_data);
+	g_task_set_source_tag (task, source_tag);
+
+	data = g_slice_new0 (ZakConfiAsyncData);
+	data->op = op;
+	g_task_set_task_data (task, data, zak_confi_async_data_free);
+
+	return task;
+}
+
+/* starts @task: the plugin's own asynchronous function is called in the
+ * task's context, where its callback is dispatched; the others run on a
+ * worker thread */
+static void
+zak_confi_async_start (GTask *task)
+{
+	if (((ZakConfiAsyncData *)g_task_get_task_data (task))->native)
+		{
+			g_main_context_invoke (g_task_get_context (task), zak_confi_async_start_native, task);
+		}
+	else
+		{
+			g_thread_pool_push (async_pool, task, NULL);
+		}
+}
+
+/* queues @task, taking its reference; if another operation of the same
+ * ZakConfi is running, @task waits for it */
+static void
+zak_confi_async_run (GTask *task)
+{
+	static gsize initialized = 0;
+	ZakConfi *confi;
+	ZakConfiPrivate *priv;
+
+	if (g_once_init_enter (&initialized))
+		{
+			async_pool = g_thread_pool_new (zak_confi_async_worker, NULL, ZAK_CONFI_ASYNC_MAX_THREADS, FALSE, NULL);
+			g_once_init_leave (&initialized, 1);
+		}
+
+	confi = (ZakConfi *)g_task_get_source_object (task);
+	if (confi != NULL)
+		{
+			priv = ZAK_CONFI_GET_PRIVATE (confi);
+			g_mutex_lock (&priv->lock);
+			if (priv->async_running)
+				{
+					g_queue_push_tail (&priv->async_pending, task);
+					g_mutex_unlock (&priv->lock);
+					return;
+				}
+			priv->async_running = TRUE;
+			g_mutex_unlock (&priv->lock);
+		}
+
+	zak_confi_async_start (task);
+}
+
+/* @task returned its result: starts the next operation of its ZakConfi
+ * and drops the reference taken by zak_confi_async_run() */
+static void
+zak_confi_async_done (GTask *task)
+{
+	GTask *next;
+	ZakConfi *confi;
+	ZakConfiPrivate *priv;
+
+	confi = (ZakConfi *)g_task_get_source_object (task);
+	if (confi != NULL)
+		{
+			priv = ZAK_CONFI_GET_PRIVATE (confi);
+			g_mutex_lock (&priv->lock);
+			next = (GTask *)g_queue_pop_head (&priv->async_pending);
+			if (next == NULL)
+				{
+					priv->async_running = FALSE;
+				}
+			g_mutex_unlock (&priv->lock);
+
+			if (next != NULL)
+				{
+					zak_confi_async_start (next);
+				}
+		}
+
+	g_object_unref (task);
+}
+
+/* calls the plugin's own asynchronous function for @task; the values in
+ * cache are read here, in turn with the other operations */
+static gboolean
+zak_confi_async_start_native (gpointer user_data)
+{
+	GTask *task = (GTask *)user_data;
+	ZakConfiAsyncData *adata;
+	ZakConfiPrivate *priv;
+	GPtrArray *missing;
+	gchar *value;
+
+	adata = (ZakConfiAsyncData *)g_task_get_task_data (task);
+	priv = ZAK_CONFI_GET_PRIVATE (g_task_get_source_object (task));
+
+	if (g_task_return_error_if_cancelled (task))
+		{
+			zak_confi_async_done (task);
+			return G_SOURCE_REMOVE;
+		}
+
+	switch (adata->op)
+		{
+			case ZAK_CONFI_ASYNC_GET_TREE:
+				zak_confi_pluggable_get_tree_async (priv->pluggable, g_task_get_cancellable (task), zak_confi_get_tree_native_cb, task);
+				break;
+
+			case ZAK_CONFI_ASYNC_PATH_GET_VALUE:
+				/* the normalized path, for the cache */
+				if (priv->cache_size > 0)
+					{
+						adata->key = zak_confi_path_normalize (priv->pluggable, adata->path);
+						value = (adata->key != NULL ? zak_confi_cache_get ((ZakConfi *)g_task_get_source_object (task), adata->key) : NULL);
+						if (value != NULL)
+							{
+								g_task_return_pointer (task, value, g_free);
+								zak_confi_async_done (task);
+								break;
+							}
+					}
+				zak_confi_pluggable_path_get_value_async (priv->pluggable, adata->path, g_task_get_cancellable (task), zak_confi_path_get_value_native_cb, task);
+				break;
+
+			case ZAK_CONFI_ASYNC_PATHS_GET_VALUES:
+				adata->values = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+				missing = zak_confi_paths_get_cached ((ZakConfi *)g_task_get_source_object (task), (const gchar **)adata->paths, adata->values);
+				if (missing->len == 0)
+					{
+						g_task_return_pointer (task, g_hash_table_ref (adata->values), (GDestroyNotify)g_hash_table_unref);
+						zak_confi_async_done (task);
+					}
+				else
+					{
+						/* the strings belong to adata->paths, that lives with the task */
+						g_ptr_array_add (missing, NULL);
+						zak_confi_pluggable_paths_get_values_async (priv->pluggable, (const gchar **)missing->pdata, g_task_get_cancellable (task), zak_confi_paths_get_values_native_cb, task);
+					}
+				g_ptr_array_free (missing, TRUE);
+				break;
+
+			case ZAK_CONFI_ASYNC_PATH_SET_VALUE:
+				zak_confi_pluggable_path_set_value_async (priv->pluggable, adata->path, adata->value, g_task_get_cancellable (task), zak_confi_path_set_value_native_cb, task);
+				break;
+
+			default:
+				g_assert_not_reached ();
+		}
+
+	return G_SOURCE_REMOVE;
+}
+
+/* runs the operation of @task, with its changes notified in the task's
+ * context, then starts the next one of its ZakConfi */
+static void
+zak_confi_async_worker (gpointer data, gpointer user_data)
+{
+	GTask *task = (GTask *)data;
+
+	if (!g_task_return_error_if_cancelled (task))
+		{
+			g_private_set (&async_context, g_task_get_context (task));
+			zak_confi_async_dispatch (task, (ZakConfi *)g_task_get_source_object (task), (ZakConfiAsyncData *)g_task_get_task_data (task));
+			g_private_set (&async_context, NULL);
+		}
+
+	zak_confi_async_done (task);
+}
+
+/* runs the synchronous operation of @task and returns its result */
+static void
+zak_confi_async_dispatch (GTask *task, ZakConfi *confi, ZakConfiAsyncData *adata)
+{
+	switch (adata->op)
+		{
+			case ZAK_CONFI_ASYNC_NEW:
+				g_task_return_pointer (task, zak_confi_new (adata->path), zak_confi_async_free_confi);
+				break;
+
+			case ZAK_CONFI_ASYNC_GET_CONFIGS_LIST:
+				g_task_return_pointer (task, zak_confi_get_configs_list (adata->path, adata->value), zak_confi_async_free_configs_list);
+				break;
+
+			case ZAK_CONFI_ASYNC_GET_TREE:
+				g_task_return_pointer (task, zak_confi_get_tree (confi), zak_confi_async_free_tree);
+				break;
+
+			case ZAK_CONFI_ASYNC_SNAPSHOT_NEW:
+				g_task_return_pointer (task, zak_confi_snapshot_new (confi), (GDestroyNotify)zak_confi_snapshot_unref);
+				break;
+
+			case ZAK_CONFI_ASYNC_ADD_KEY:
+				g_task_return_pointer (task, zak_confi_add_key (confi, adata->path, adata->key, adata->value), zak_confi_async_free_key);
+				break;
+
+			case ZAK_CONFI_ASYNC_KEY_SET_KEY:
+				g_task_return_boolean (task, zak_confi_key_set_key (confi, adata->ck));
+				break;
+
+			case ZAK_CONFI_ASYNC_REMOVE_PATH:
+				g_task_return_boolean (task, zak_confi_remove_path (confi, adata->path));
+				break;
+
+			case ZAK_CONFI_ASYNC_PATH_GET_VALUE:
+				g_task_return_pointer (task, zak_confi_path_get_value (confi, adata->path), g_free);
+				break;
+
+			case ZAK_CONFI_ASYNC_PATHS_GET_VALUES:
+				g_task_return_pointer (task, zak_confi_paths_get_values (confi, (const gchar **)adata->paths), (GDestroyNotify)g_hash_table_destroy);
+				break;
+
+			case ZAK_CONFI_ASYNC_PATH_SET_VALUE:
+				g_task_return_boolean (task, zak_confi_path_set_value (confi, adata->path, adata->value));
+				break;
+
+			case ZAK_CONFI_ASYNC_PATH_GET_CONFI_KEY:
+				g_task_return_pointer (task, zak_confi_path_get_confi_key (confi, adata->path), zak_confi_async_free_key);
+				break;
+
+			case ZAK_CONFI_ASYNC_BEGIN:
+				g_task_return_boolean (task, zak_confi_begin (confi));
+				break;
+
+			case ZAK_CONFI_ASYNC_COMMIT:
+				g_task_return_boolean (task, zak_confi_commit (confi));
+				break;
+
+			case ZAK_CONFI_ASYNC_ROLLBACK:
+				g_task_return_boolean (task, zak_confi_rollback (confi));
+				break;
+
+			case ZAK_CONFI_ASYNC_FLUSH:
+				g_task_return_boolean (task, zak_confi_flush (confi));
+				break;
+
+			case ZAK_CONFI_ASYNC_REMOVE:
+				g_task_return_boolean (task, zak_confi_remove (confi));
 				break;
 		}
 }
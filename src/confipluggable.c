@@ -24,6 +24,7 @@
 #endif
 
 #include "confipluggable.h"
+#include "libzakconfi.h"
 
 /**
  * SECTION:confipluggable
@@ -85,6 +86,37 @@ zak_confi_pluggable_default_init (ZakConfiPluggableInterface *iface)
 			                                                          "/",
 			                                                          G_PARAM_READWRITE | G_PARAM_CONSTRUCT));
 
+			/**
+			* ZakConfiPluggable:intern_values:
+			*
+			* Whether the trees share the copies of equal values and
+			* descriptions, as they always do for key names and paths.
+			*/
+			g_object_interface_install_property (iface,
+			                                     g_param_spec_boolean ("intern_values",
+			                                                           "Intern values",
+			                                                           "Share equal values in the trees",
+			                                                           FALSE,
+			                                                           G_PARAM_READWRITE));
+
+			/**
+			* ZakConfiPluggable::changed:
+			* @pluggable: the #ZakConfiPluggable.
+			* @path: the normalized path (with root) that changed, together
+			* with every key below it; "/" for the whole configuration.
+			*
+			* Emitted by the plugin for the changes made outside it.
+			*/
+			g_signal_new ("changed",
+			              ZAK_CONFI_TYPE_PLUGGABLE,
+			              G_SIGNAL_RUN_LAST,
+			              0,
+			              NULL,
+			              NULL,
+			              g_cclosure_marshal_VOID__STRING,
+			              G_TYPE_NONE,
+			              1, G_TYPE_STRING);
+
 			initialized = TRUE;
 		}
 }
@@ -191,6 +223,31 @@ GNode
 	return iface->get_tree (pluggable);
 }
 
+/**
+ * zak_confi_pluggable_get_subtree:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @path: the normalized path of the branch; "/" for the whole tree.
+ * @max_depth: the levels to read below @path; negative for all.
+ *
+ * Returns: a #GNode with only the branch under @path, rooted at the key
+ * of @path; NULL if @path doesn't exist or the plugin can't read only a
+ * branch.
+ */
+GNode
+*zak_confi_pluggable_get_subtree (ZakConfiPluggable *pluggable,
+                                  const gchar *path,
+                                  gint max_depth)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), NULL);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_val_if_fail (iface->get_subtree != NULL, NULL);
+
+	return iface->get_subtree (pluggable, path, max_depth);
+}
+
 /**
  * zak_confi_pluggable_add_key:
  * @pluggable: a #ZakConfiPluggable object.
@@ -291,3 +348,549 @@ zak_confi_pluggable_remove (ZakConfiPluggable *pluggable)
 
 	return iface->remove (pluggable);
 }
+
+/**
+ * zak_confi_pluggable_paths_get_values:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @paths: (array zero-terminated=1): the paths from which retrieving the values.
+ *
+ * Reads many values with only one backend operation.
+ *
+ * Returns: (transfer full) (element-type utf8 utf8): a #GHashTable with
+ * the values keyed by path; paths that don't exist are missing.
+ */
+GHashTable
+*zak_confi_pluggable_paths_get_values (ZakConfiPluggable *pluggable, const gchar **paths)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), NULL);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_val_if_fail (iface->paths_get_values != NULL, NULL);
+
+	return iface->paths_get_values (pluggable, paths);
+}
+
+/**
+ * zak_confi_pluggable_begin:
+ * @pluggable: a #ZakConfiPluggable object.
+ *
+ * Starts a transaction: the following changes are applied together
+ * on zak_confi_pluggable_commit().
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_pluggable_begin (ZakConfiPluggable *pluggable)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), FALSE);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_val_if_fail (iface->begin != NULL, FALSE);
+
+	return iface->begin (pluggable);
+}
+
+/**
+ * zak_confi_pluggable_commit:
+ * @pluggable: a #ZakConfiPluggable object.
+ *
+ * Applies every change made since zak_confi_pluggable_begin().
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_pluggable_commit (ZakConfiPluggable *pluggable)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), FALSE);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_val_if_fail (iface->commit != NULL, FALSE);
+
+	return iface->commit (pluggable);
+}
+
+/**
+ * zak_confi_pluggable_rollback:
+ * @pluggable: a #ZakConfiPluggable object.
+ *
+ * Discards every change made since zak_confi_pluggable_begin().
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_pluggable_rollback (ZakConfiPluggable *pluggable)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), FALSE);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_val_if_fail (iface->rollback != NULL, FALSE);
+
+	return iface->rollback (pluggable);
+}
+
+/**
+ * zak_confi_pluggable_flush:
+ * @pluggable: a #ZakConfiPluggable object.
+ *
+ * Writes immediately every change whose saving is deferred.
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_pluggable_flush (ZakConfiPluggable *pluggable)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), FALSE);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_val_if_fail (iface->flush != NULL, FALSE);
+
+	return iface->flush (pluggable);
+}
+
+/**
+ * zak_confi_pluggable_path_lookup_value:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @path: the key's path.
+ * @absent: (out) (optional) (transfer full): if the key doesn't exist
+ * and the plugin knows it, the topmost missing normalized path, @path
+ * itself or one of its parents: nothing below it exists; otherwise NULL.
+ *
+ * As zak_confi_pluggable_path_get_value(), but a missing key isn't logged.
+ *
+ * Returns: the value, or NULL if the key doesn't exist.
+ */
+gchar
+*zak_confi_pluggable_path_lookup_value (ZakConfiPluggable *pluggable,
+                                        const gchar *path,
+                                        gchar **absent)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), NULL);
+
+	if (absent != NULL)
+		{
+			*absent = NULL;
+		}
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	if (iface->path_lookup_value != NULL)
+		{
+			return iface->path_lookup_value (pluggable, path, absent);
+		}
+
+	/* a missing path doesn't tell anything about the paths below it */
+	return zak_confi_pluggable_path_get_value (pluggable, path);
+}
+
+/**
+ * zak_confi_pluggable_path_get_key_id:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @path: a normalized path.
+ *
+ * Returns: the backend id of the key at @path; -1 if it doesn't exist or
+ * the plugin doesn't identify the keys by id.
+ */
+gint
+zak_confi_pluggable_path_get_key_id (ZakConfiPluggable *pluggable,
+                                     const gchar *path)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), -1);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	if (iface->path_get_key_id == NULL)
+		{
+			return -1;
+		}
+
+	return iface->path_get_key_id (pluggable, path);
+}
+
+/**
+ * zak_confi_pluggable_key_id_get_value:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @id: an id returned by zak_confi_pluggable_path_get_key_id().
+ *
+ * Returns: the value of the key, or NULL if it doesn't exist anymore.
+ */
+gchar
+*zak_confi_pluggable_key_id_get_value (ZakConfiPluggable *pluggable,
+                                       gint id)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), NULL);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_val_if_fail (iface->key_id_get_value != NULL, NULL);
+
+	return iface->key_id_get_value (pluggable, id);
+}
+
+/**
+ * zak_confi_pluggable_key_id_set_value:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @id: an id returned by zak_confi_pluggable_path_get_key_id().
+ * @value: the value to set.
+ *
+ * Returns: #TRUE if success; #FALSE also if no key has @id any more.
+ */
+gboolean
+zak_confi_pluggable_key_id_set_value (ZakConfiPluggable *pluggable,
+                                      gint id,
+                                      const gchar *value)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), FALSE);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_val_if_fail (iface->key_id_set_value != NULL, FALSE);
+
+	return iface->key_id_set_value (pluggable, id, value);
+}
+
+/**
+ * zak_confi_pluggable_iter_new:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @prefix: the normalized path of the branch; "/" for the whole tree.
+ *
+ * Returns: (transfer full) (nullable): a plugin iterator over the keys
+ * under @prefix, to free with zak_confi_pluggable_iter_free(); NULL if
+ * the plugin can't stream them.
+ */
+gpointer
+zak_confi_pluggable_iter_new (ZakConfiPluggable *pluggable,
+                              const gchar *prefix)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), NULL);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	if (iface->iter_new == NULL)
+		{
+			return NULL;
+		}
+
+	return iface->iter_new (pluggable, prefix);
+}
+
+/**
+ * zak_confi_pluggable_iter_next:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @iter: an iterator returned by zak_confi_pluggable_iter_new().
+ * @path: (out) (transfer none): the normalized path of the next key.
+ * @value: (out) (transfer none) (nullable): its value.
+ *
+ * Returns: #FALSE when there are no more keys.
+ */
+gboolean
+zak_confi_pluggable_iter_next (ZakConfiPluggable *pluggable,
+                               gpointer iter,
+                               const gchar **path,
+                               const gchar **value)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), FALSE);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_val_if_fail (iface->iter_next != NULL, FALSE);
+
+	return iface->iter_next (pluggable, iter, path, value);
+}
+
+/**
+ * zak_confi_pluggable_iter_free:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @iter: an iterator returned by zak_confi_pluggable_iter_new().
+ *
+ */
+void
+zak_confi_pluggable_iter_free (ZakConfiPluggable *pluggable,
+                               gpointer iter)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable));
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_if_fail (iface->iter_free != NULL);
+
+	iface->iter_free (pluggable, iter);
+}
+
+/**
+ * zak_confi_pluggable_get_revision:
+ * @pluggable: a #ZakConfiPluggable object.
+ *
+ * Returns: the revision of the configuration, incremented by every write;
+ * -1 if the plugin doesn't track the changes.
+ */
+gint64
+zak_confi_pluggable_get_revision (ZakConfiPluggable *pluggable)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), -1);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	if (iface->get_revision == NULL)
+		{
+			return -1;
+		}
+
+	return iface->get_revision (pluggable);
+}
+
+/**
+ * zak_confi_pluggable_get_changes_since:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @revision: a revision returned by zak_confi_pluggable_get_revision().
+ *
+ * Returns: (transfer full) (element-type utf8 utf8) (nullable): the
+ * normalized paths written after @revision with their values; the removed
+ * paths have a NULL value. NULL if the changes since @revision aren't
+ * known.
+ */
+GHashTable
+*zak_confi_pluggable_get_changes_since (ZakConfiPluggable *pluggable, gint64 revision)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), NULL);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	if (iface->get_changes_since == NULL)
+		{
+			return NULL;
+		}
+
+	return iface->get_changes_since (pluggable, revision);
+}
+
+/**
+ * zak_confi_pluggable_changed:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @path: (nullable): the normalized path that changed; NULL for the
+ * whole configuration.
+ *
+ * To be called by the plugins when the backend is changed from outside.
+ */
+void
+zak_confi_pluggable_changed (ZakConfiPluggable *pluggable, const gchar *path)
+{
+	g_return_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable));
+
+	g_signal_emit_by_name (pluggable, "changed", (path != NULL ? path : "/"));
+}
+
+/**
+ * zak_confi_pluggable_path_get_value_async:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @path: the path from which retrieving the value.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the value is read.
+ * @user_data: data for @callback.
+ *
+ */
+void
+zak_confi_pluggable_path_get_value_async (ZakConfiPluggable *pluggable,
+                                          const gchar *path,
+                                          GCancellable *cancellable,
+                                          GAsyncReadyCallback callback,
+                                          gpointer user_data)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable));
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_if_fail (iface->path_get_value_async != NULL);
+
+	iface->path_get_value_async (pluggable, path, cancellable, callback, user_data);
+}
+
+/**
+ * zak_confi_pluggable_path_get_value_finish:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: the value of the path.
+ */
+gchar
+*zak_confi_pluggable_path_get_value_finish (ZakConfiPluggable *pluggable,
+                                           GAsyncResult *result,
+                                           GError **error)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), NULL);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_val_if_fail (iface->path_get_value_finish != NULL, NULL);
+
+	return iface->path_get_value_finish (pluggable, result, error);
+}
+
+/**
+ * zak_confi_pluggable_paths_get_values_async:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @paths: (array zero-terminated=1): the paths from which retrieving the values.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the values are read.
+ * @user_data: data for @callback.
+ *
+ */
+void
+zak_confi_pluggable_paths_get_values_async (ZakConfiPluggable *pluggable,
+                                            const gchar **paths,
+                                            GCancellable *cancellable,
+                                            GAsyncReadyCallback callback,
+                                            gpointer user_data)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable));
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_if_fail (iface->paths_get_values_async != NULL);
+
+	iface->paths_get_values_async (pluggable, paths, cancellable, callback, user_data);
+}
+
+/**
+ * zak_confi_pluggable_paths_get_values_finish:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: (transfer full) (element-type utf8 utf8): a #GHashTable with
+ * the values keyed by path; paths that don't exist are missing.
+ */
+GHashTable
+*zak_confi_pluggable_paths_get_values_finish (ZakConfiPluggable *pluggable,
+                                             GAsyncResult *result,
+                                             GError **error)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), NULL);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_val_if_fail (iface->paths_get_values_finish != NULL, NULL);
+
+	return iface->paths_get_values_finish (pluggable, result, error);
+}
+
+/**
+ * zak_confi_pluggable_path_set_value_async:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @path: the key's path.
+ * @value: the value to set.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the value is written.
+ * @user_data: data for @callback.
+ *
+ */
+void
+zak_confi_pluggable_path_set_value_async (ZakConfiPluggable *pluggable,
+                                          const gchar *path,
+                                          const gchar *value,
+                                          GCancellable *cancellable,
+                                          GAsyncReadyCallback callback,
+                                          gpointer user_data)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable));
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_if_fail (iface->path_set_value_async != NULL);
+
+	iface->path_set_value_async (pluggable, path, value, cancellable, callback, user_data);
+}
+
+/**
+ * zak_confi_pluggable_path_set_value_finish:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: #TRUE if success.
+ */
+gboolean
+zak_confi_pluggable_path_set_value_finish (ZakConfiPluggable *pluggable,
+                                           GAsyncResult *result,
+                                           GError **error)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), FALSE);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_val_if_fail (iface->path_set_value_finish != NULL, FALSE);
+
+	return iface->path_set_value_finish (pluggable, result, error);
+}
+
+/**
+ * zak_confi_pluggable_get_tree_async:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @cancellable: (nullable): a #GCancellable.
+ * @callback: the function to call when the tree is read.
+ * @user_data: data for @callback.
+ *
+ */
+void
+zak_confi_pluggable_get_tree_async (ZakConfiPluggable *pluggable,
+                                    GCancellable *cancellable,
+                                    GAsyncReadyCallback callback,
+                                    gpointer user_data)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable));
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_if_fail (iface->get_tree_async != NULL);
+
+	iface->get_tree_async (pluggable, cancellable, callback, user_data);
+}
+
+/**
+ * zak_confi_pluggable_get_tree_finish:
+ * @pluggable: a #ZakConfiPluggable object.
+ * @result: a #GAsyncResult.
+ * @error: return location for a #GError.
+ *
+ * Returns: a #GNode with the entire tree of configurations.
+ */
+GNode
+*zak_confi_pluggable_get_tree_finish (ZakConfiPluggable *pluggable,
+                                     GAsyncResult *result,
+                                     GError **error)
+{
+	ZakConfiPluggableInterface *iface;
+
+	g_return_val_if_fail (ZAK_CONFI_IS_PLUGGABLE (pluggable), NULL);
+
+	iface = ZAK_CONFI_PLUGGABLE_GET_IFACE (pluggable);
+	g_return_val_if_fail (iface->get_tree_finish != NULL, NULL);
+
+	return iface->get_tree_finish (pluggable, result, error);
+}
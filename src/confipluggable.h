@@ -23,6 +23,7 @@
 #define __ZAK_CONFI_PLUGGABLE_H__
 
 #include <glib-object.h>
+#include <gio/gio.h>
 
 #include "commons.h"
 
@@ -64,6 +65,9 @@ struct _ZakConfiPluggableInterface {
 	                            const gchar *path,
 	                            const gchar *value);
 	GNode *(*get_tree) (ZakConfiPluggable *pluggable);
+	GNode *(*get_subtree) (ZakConfiPluggable *pluggable,
+	                       const gchar *path,
+	                       gint max_depth);
 	ZakConfiKey *(*add_key) (ZakConfiPluggable *pluggable,
 	                      const gchar *parent,
 	                      const gchar *key,
@@ -74,6 +78,80 @@ struct _ZakConfiPluggableInterface {
 	gboolean (*remove) (ZakConfiPluggable *pluggable);
 	gboolean (*key_set_key) (ZakConfiPluggable *pluggable,
 	                         ZakConfiKey *ck);
+	GHashTable *(*paths_get_values) (ZakConfiPluggable *pluggable,
+	                                 const gchar **paths);
+	gboolean (*begin) (ZakConfiPluggable *pluggable);
+	gboolean (*commit) (ZakConfiPluggable *pluggable);
+	gboolean (*rollback) (ZakConfiPluggable *pluggable);
+	gboolean (*flush) (ZakConfiPluggable *pluggable);
+
+	/* Optional lookup that doesn't log a missing key; it returns in
+	 * @absent the topmost missing normalized path, if known, below
+	 * which nothing exists */
+	gchar *(*path_lookup_value) (ZakConfiPluggable *pluggable,
+	                             const gchar *path,
+	                             gchar **absent);
+
+	/* Optional access to the keys by a backend id, resolved once from a
+	 * normalized path; -1 if the path doesn't exist */
+	gint (*path_get_key_id) (ZakConfiPluggable *pluggable,
+	                         const gchar *path);
+	gchar *(*key_id_get_value) (ZakConfiPluggable *pluggable,
+	                            gint id);
+	gboolean (*key_id_set_value) (ZakConfiPluggable *pluggable,
+	                              gint id,
+	                              const gchar *value);
+
+	/* Optional streaming of the keys under a normalized prefix, in path
+	 * order; the strings returned by iter_next are owned by the iterator */
+	gpointer (*iter_new) (ZakConfiPluggable *pluggable,
+	                      const gchar *prefix);
+	gboolean (*iter_next) (ZakConfiPluggable *pluggable,
+	                       gpointer iter,
+	                       const gchar **path,
+	                       const gchar **value);
+	void (*iter_free) (ZakConfiPluggable *pluggable,
+	                   gpointer iter);
+
+	/* Optional change tracking */
+	gint64 (*get_revision) (ZakConfiPluggable *pluggable);
+	GHashTable *(*get_changes_since) (ZakConfiPluggable *pluggable,
+	                                  gint64 revision);
+
+	/* Optional native asynchronous methods: without them, ZakConfi
+	 * runs the synchronous ones on its worker threads */
+	void (*path_get_value_async) (ZakConfiPluggable *pluggable,
+	                              const gchar *path,
+	                              GCancellable *cancellable,
+	                              GAsyncReadyCallback callback,
+	                              gpointer user_data);
+	gchar *(*path_get_value_finish) (ZakConfiPluggable *pluggable,
+	                                 GAsyncResult *result,
+	                                 GError **error);
+	void (*paths_get_values_async) (ZakConfiPluggable *pluggable,
+	                                const gchar **paths,
+	                                GCancellable *cancellable,
+	                                GAsyncReadyCallback callback,
+	                                gpointer user_data);
+	GHashTable *(*paths_get_values_finish) (ZakConfiPluggable *pluggable,
+	                                        GAsyncResult *result,
+	                                        GError **error);
+	void (*path_set_value_async) (ZakConfiPluggable *pluggable,
+	                              const gchar *path,
+	                              const gchar *value,
+	                              GCancellable *cancellable,
+	                              GAsyncReadyCallback callback,
+	                              gpointer user_data);
+	gboolean (*path_set_value_finish) (ZakConfiPluggable *pluggable,
+	                                   GAsyncResult *result,
+	                                   GError **error);
+	void (*get_tree_async) (ZakConfiPluggable *pluggable,
+	                        GCancellable *cancellable,
+	                        GAsyncReadyCallback callback,
+	                        gpointer user_data);
+	GNode *(*get_tree_finish) (ZakConfiPluggable *pluggable,
+	                           GAsyncResult *result,
+	                           GError **error);
 };
 
 /*
@@ -92,6 +170,9 @@ gboolean zak_confi_pluggable_path_set_value (ZakConfiPluggable *pluggable,
                                const gchar *path,
                                const gchar *value);
 GNode *zak_confi_pluggable_get_tree (ZakConfiPluggable *pluggable);
+GNode *zak_confi_pluggable_get_subtree (ZakConfiPluggable *pluggable,
+                                        const gchar *path,
+                                        gint max_depth);
 ZakConfiKey *zak_confi_pluggable_add_key (ZakConfiPluggable *pluggable,
                                    const gchar *parent,
                                    const gchar *key,
@@ -101,6 +182,72 @@ gboolean zak_confi_pluggable_key_set_key (ZakConfiPluggable *pluggable,
 ZakConfiKey *zak_confi_pluggable_path_get_confi_key (ZakConfiPluggable *pluggable, const gchar *path);
 gboolean zak_confi_pluggable_remove_path (ZakConfiPluggable *pluggable, const gchar *path);
 gboolean zak_confi_pluggable_remove (ZakConfiPluggable *pluggable);
+GHashTable *zak_confi_pluggable_paths_get_values (ZakConfiPluggable *pluggable,
+                                                  const gchar **paths);
+gboolean zak_confi_pluggable_begin (ZakConfiPluggable *pluggable);
+gboolean zak_confi_pluggable_commit (ZakConfiPluggable *pluggable);
+gboolean zak_confi_pluggable_rollback (ZakConfiPluggable *pluggable);
+gboolean zak_confi_pluggable_flush (ZakConfiPluggable *pluggable);
+
+gchar *zak_confi_pluggable_path_lookup_value (ZakConfiPluggable *pluggable,
+                                              const gchar *path,
+                                              gchar **absent);
+
+gint zak_confi_pluggable_path_get_key_id (ZakConfiPluggable *pluggable,
+                                          const gchar *path);
+gchar *zak_confi_pluggable_key_id_get_value (ZakConfiPluggable *pluggable,
+                                             gint id);
+gboolean zak_confi_pluggable_key_id_set_value (ZakConfiPluggable *pluggable,
+                                               gint id,
+                                               const gchar *value);
+
+gpointer zak_confi_pluggable_iter_new (ZakConfiPluggable *pluggable,
+                                       const gchar *prefix);
+gboolean zak_confi_pluggable_iter_next (ZakConfiPluggable *pluggable,
+                                        gpointer iter,
+                                        const gchar **path,
+                                        const gchar **value);
+void zak_confi_pluggable_iter_free (ZakConfiPluggable *pluggable,
+                                    gpointer iter);
+
+gint64 zak_confi_pluggable_get_revision (ZakConfiPluggable *pluggable);
+GHashTable *zak_confi_pluggable_get_changes_since (ZakConfiPluggable *pluggable,
+                                                   gint64 revision);
+
+void zak_confi_pluggable_changed (ZakConfiPluggable *pluggable, const gchar *path);
+
+void zak_confi_pluggable_path_get_value_async (ZakConfiPluggable *pluggable,
+                                               const gchar *path,
+                                               GCancellable *cancellable,
+                                               GAsyncReadyCallback callback,
+                                               gpointer user_data);
+gchar *zak_confi_pluggable_path_get_value_finish (ZakConfiPluggable *pluggable,
+                                                  GAsyncResult *result,
+                                                  GError **error);
+void zak_confi_pluggable_paths_get_values_async (ZakConfiPluggable *pluggable,
+                                                 const gchar **paths,
+                                                 GCancellable *cancellable,
+                                                 GAsyncReadyCallback callback,
+                                                 gpointer user_data);
+GHashTable *zak_confi_pluggable_paths_get_values_finish (ZakConfiPluggable *pluggable,
+                                                         GAsyncResult *result,
+                                                         GError **error);
+void zak_confi_pluggable_path_set_value_async (ZakConfiPluggable *pluggable,
+                                               const gchar *path,
+                                               const gchar *value,
+                                               GCancellable *cancellable,
+                                               GAsyncReadyCallback callback,
+                                               gpointer user_data);
+gboolean zak_confi_pluggable_path_set_value_finish (ZakConfiPluggable *pluggable,
+                                                    GAsyncResult *result,
+                                                    GError **error);
+void zak_confi_pluggable_get_tree_async (ZakConfiPluggable *pluggable,
+                                         GCancellable *cancellable,
+                                         GAsyncReadyCallback callback,
+                                         gpointer user_data);
+GNode *zak_confi_pluggable_get_tree_finish (ZakConfiPluggable *pluggable,
+                                            GAsyncResult *result,
+                                            GError **error);
 
 
 G_END_DECLS
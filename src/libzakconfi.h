@@ -20,6 +20,7 @@
 #define __LIBZAKCONFI_H__
 
 #include <glib-object.h>
+#include <gio/gio.h>
 
 #include <libpeas/peas.h>
 
@@ -49,8 +50,18 @@ struct _ZakConfi
 struct _ZakConfiClass
 	{
 		GObjectClass parent_class;
+
+		void (*changed) (ZakConfi *confi, const gchar *path);
 	};
 
+typedef void (*ZakConfiWatchFunc) (ZakConfi *confi, const gchar *path, gpointer user_data);
+
+typedef struct _ZakConfiIter ZakConfiIter;
+typedef struct _ZakConfiPathHandle ZakConfiPathHandle;
+
+/* returns TRUE to stop the iteration */
+typedef gboolean (*ZakConfiForeachFunc) (ZakConfi *confi, const gchar *path, const gchar *value, gpointer user_data);
+
 GType zak_confi_get_type (void);
 
 ZakConfi *zak_confi_new (const gchar *cnc_string);
@@ -61,9 +72,23 @@ GList *zak_confi_get_configs_list (const gchar *cnc_string,
                                const gchar *filter);
 
 GNode *zak_confi_get_tree (ZakConfi *confi);
+GNode *zak_confi_get_subtree (ZakConfi *confi, const gchar *path, gint max_depth);
+ZakConfiTree *zak_confi_get_tree_compact (ZakConfi *confi);
+
+ZakConfiIter *zak_confi_iter_new (ZakConfi *confi, const gchar *prefix);
+gboolean zak_confi_iter_next (ZakConfiIter *iter, const gchar **path, const gchar **value);
+void zak_confi_iter_free (ZakConfiIter *iter);
+
+void zak_confi_foreach (ZakConfi *confi,
+                        const gchar *prefix,
+                        ZakConfiForeachFunc func,
+                        gpointer user_data);
+
+ZakConfiSnapshot *zak_confi_snapshot_new (ZakConfi *confi);
 
 gchar *zak_confi_normalize_root (const gchar *root);
 gboolean zak_confi_set_root (ZakConfi *confi, const gchar *root);
+void zak_confi_set_intern_values (ZakConfi *confi, gboolean intern);
 
 ZakConfiKey *zak_confi_add_key (ZakConfi *confi,
                          const gchar *parent,
@@ -78,6 +103,22 @@ gboolean zak_confi_remove_path (ZakConfi *confi,
 
 gchar *zak_confi_path_get_value (ZakConfi *confi,
                              const gchar *path);
+gchar *zak_confi_path_lookup_value (ZakConfi *confi,
+                                    const gchar *path);
+gint zak_confi_path_get_int (ZakConfi *confi,
+                             const gchar *path,
+                             gint default_value);
+gboolean zak_confi_path_get_boolean (ZakConfi *confi,
+                                     const gchar *path,
+                                     gboolean default_value);
+gdouble zak_confi_path_get_double (ZakConfi *confi,
+                                   const gchar *path,
+                                   gdouble default_value);
+gchar **zak_confi_path_get_strv (ZakConfi *confi,
+                                 const gchar *path,
+                                 const gchar * const *default_value);
+GHashTable *zak_confi_paths_get_values (ZakConfi *confi,
+                                        const gchar **paths);
 gboolean zak_confi_path_set_value (ZakConfi *confi,
                                const gchar *path,
                                const gchar *value);
@@ -85,12 +126,141 @@ gboolean zak_confi_path_set_value (ZakConfi *confi,
 ZakConfiKey *zak_confi_path_get_confi_key (ZakConfi *confi,
                                     const gchar *path);
 
+ZakConfiPathHandle *zak_confi_path_compile (ZakConfi *confi, const gchar *path);
+void zak_confi_path_handle_free (ZakConfiPathHandle *handle);
+gchar *zak_confi_handle_get_value (ZakConfiPathHandle *handle);
+gboolean zak_confi_handle_set_value (ZakConfiPathHandle *handle, const gchar *value);
+
+gboolean zak_confi_begin (ZakConfi *confi);
+gboolean zak_confi_commit (ZakConfi *confi);
+gboolean zak_confi_rollback (ZakConfi *confi);
+
+gboolean zak_confi_flush (ZakConfi *confi);
+
+gint64 zak_confi_get_revision (ZakConfi *confi);
+GHashTable *zak_confi_get_changes_since (ZakConfi *confi, gint64 revision);
+
 gboolean zak_confi_remove (ZakConfi *confi);
 
 void zak_confi_destroy (ZakConfi *confi);
 
+void zak_confi_set_cache_size (ZakConfi *confi, guint size);
+guint zak_confi_get_cache_size (ZakConfi *confi);
+void zak_confi_get_cache_stats (ZakConfi *confi, guint *hits, guint *misses, guint *size);
+void zak_confi_cache_clear (ZakConfi *confi);
+
+gulong zak_confi_watch (ZakConfi *confi,
+                        const gchar *prefix,
+                        ZakConfiWatchFunc func,
+                        gpointer user_data,
+                        GDestroyNotify notify);
+void zak_confi_unwatch (ZakConfi *confi, gulong id);
+
 gchar *zak_confi_path_normalize (ZakConfiPluggable *pluggable, const gchar *path);
 
+void zak_confi_new_async (const gchar *cnc_string,
+                          GCancellable *cancellable,
+                          GAsyncReadyCallback callback,
+                          gpointer user_data);
+ZakConfi *zak_confi_new_finish (GAsyncResult *result, GError **error);
+
+void zak_confi_get_configs_list_async (const gchar *cnc_string,
+                                       const gchar *filter,
+                                       GCancellable *cancellable,
+                                       GAsyncReadyCallback callback,
+                                       gpointer user_data);
+GList *zak_confi_get_configs_list_finish (GAsyncResult *result, GError **error);
+
+void zak_confi_get_tree_async (ZakConfi *confi,
+                               GCancellable *cancellable,
+                               GAsyncReadyCallback callback,
+                               gpointer user_data);
+GNode *zak_confi_get_tree_finish (ZakConfi *confi, GAsyncResult *result, GError **error);
+
+void zak_confi_snapshot_new_async (ZakConfi *confi,
+                                   GCancellable *cancellable,
+                                   GAsyncReadyCallback callback,
+                                   gpointer user_data);
+ZakConfiSnapshot *zak_confi_snapshot_new_finish (ZakConfi *confi, GAsyncResult *result, GError **error);
+
+void zak_confi_add_key_async (ZakConfi *confi,
+                              const gchar *parent,
+                              const gchar *key,
+                              const gchar *value,
+                              GCancellable *cancellable,
+                              GAsyncReadyCallback callback,
+                              gpointer user_data);
+ZakConfiKey *zak_confi_add_key_finish (ZakConfi *confi, GAsyncResult *result, GError **error);
+
+void zak_confi_key_set_key_async (ZakConfi *confi,
+                                  ZakConfiKey *ck,
+                                  GCancellable *cancellable,
+                                  GAsyncReadyCallback callback,
+                                  gpointer user_data);
+gboolean zak_confi_key_set_key_finish (ZakConfi *confi, GAsyncResult *result, GError **error);
+
+void zak_confi_remove_path_async (ZakConfi *confi,
+                                  const gchar *path,
+                                  GCancellable *cancellable,
+                                  GAsyncReadyCallback callback,
+                                  gpointer user_data);
+gboolean zak_confi_remove_path_finish (ZakConfi *confi, GAsyncResult *result, GError **error);
+
+void zak_confi_path_get_value_async (ZakConfi *confi,
+                                     const gchar *path,
+                                     GCancellable *cancellable,
+                                     GAsyncReadyCallback callback,
+                                     gpointer user_data);
+gchar *zak_confi_path_get_value_finish (ZakConfi *confi, GAsyncResult *result, GError **error);
+void zak_confi_paths_get_values_async (ZakConfi *confi,
+                                       const gchar **paths,
+                                       GCancellable *cancellable,
+                                       GAsyncReadyCallback callback,
+                                       gpointer user_data);
+GHashTable *zak_confi_paths_get_values_finish (ZakConfi *confi, GAsyncResult *result, GError **error);
+void zak_confi_path_set_value_async (ZakConfi *confi,
+                                     const gchar *path,
+                                     const gchar *value,
+                                     GCancellable *cancellable,
+                                     GAsyncReadyCallback callback,
+                                     gpointer user_data);
+gboolean zak_confi_path_set_value_finish (ZakConfi *confi, GAsyncResult *result, GError **error);
+
+void zak_confi_path_get_confi_key_async (ZakConfi *confi,
+                                         const gchar *path,
+                                         GCancellable *cancellable,
+                                         GAsyncReadyCallback callback,
+                                         gpointer user_data);
+ZakConfiKey *zak_confi_path_get_confi_key_finish (ZakConfi *confi, GAsyncResult *result, GError **error);
+
+void zak_confi_begin_async (ZakConfi *confi,
+                            GCancellable *cancellable,
+                            GAsyncReadyCallback callback,
+                            gpointer user_data);
+gboolean zak_confi_begin_finish (ZakConfi *confi, GAsyncResult *result, GError **error);
+void zak_confi_commit_async (ZakConfi *confi,
+                             GCancellable *cancellable,
+                             GAsyncReadyCallback callback,
+                             gpointer user_data);
+gboolean zak_confi_commit_finish (ZakConfi *confi, GAsyncResult *result, GError **error);
+void zak_confi_rollback_async (ZakConfi *confi,
+                               GCancellable *cancellable,
+                               GAsyncReadyCallback callback,
+                               gpointer user_data);
+gboolean zak_confi_rollback_finish (ZakConfi *confi, GAsyncResult *result, GError **error);
+
+void zak_confi_flush_async (ZakConfi *confi,
+                            GCancellable *cancellable,
+                            GAsyncReadyCallback callback,
+                            gpointer user_data);
+gboolean zak_confi_flush_finish (ZakConfi *confi, GAsyncResult *result, GError **error);
+
+void zak_confi_remove_async (ZakConfi *confi,
+                             GCancellable *cancellable,
+                             GAsyncReadyCallback callback,
+                             gpointer user_data);
+gboolean zak_confi_remove_finish (ZakConfi *confi, GAsyncResult *result, GError **error);
+
 
 G_END_DECLS
 
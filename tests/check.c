@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2016 Andrea Zagli <azagli@libero.it>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/* Run by "make check" on a copy of conf.conf, through the file plugin. */
+
+#include <glib/gstdio.h>
+#include <libpeas/peas.h>
+
+#include "libzakconfi.h"
+
+static gchar *filename;
+
+static ZakConfi
+*check_confi_new (void)
+{
+	ZakConfi *confi;
+	gchar *cnc_string;
+
+	cnc_string = g_strdup_printf ("file://%s", filename);
+	confi = zak_confi_new (cnc_string);
+	g_free (cnc_string);
+
+	g_assert (confi != NULL);
+
+	return confi;
+}
+
+static void
+test_cache (void)
+{
+	ZakConfi *confi;
+	GHashTable *values;
+	gchar *value;
+	guint hits;
+	guint misses;
+	guint size;
+
+	const gchar *paths[] = { "folder/key1/key1_1", "/folder/key1/key1_1", "folder/key1/key1_2", NULL };
+
+	confi = check_confi_new ();
+	zak_confi_set_cache_size (confi, 2);
+
+	value = zak_confi_path_get_value (confi, "folder/key2");
+	g_assert_cmpstr (value, ==, "value key 2");
+	g_free (value);
+	value = zak_confi_path_get_value (confi, "folder/key2");
+	g_assert_cmpstr (value, ==, "value key 2");
+	g_free (value);
+
+	zak_confi_get_cache_stats (confi, &hits, &misses, &size);
+	g_assert_cmpuint (hits, ==, 1);
+	g_assert_cmpuint (misses, ==, 1);
+	g_assert_cmpuint (size, ==, 1);
+
+	/* two spellings of the same path are cached once */
+	values = zak_confi_paths_get_values (confi, paths);
+	g_assert_cmpstr (g_hash_table_lookup (values, "folder/key1/key1_1"), ==, "value key 1 1");
+	g_assert_cmpstr (g_hash_table_lookup (values, "/folder/key1/key1_1"), ==, "value key 1 1");
+	g_hash_table_destroy (values);
+
+	zak_confi_get_cache_stats (confi, NULL, NULL, &size);
+	g_assert_cmpuint (size, ==, 2);
+
+	/* the least recently used values go out */
+	value = zak_confi_path_get_value (confi, "folder/key2");
+	g_assert_cmpstr (value, ==, "value key 2");
+	g_free (value);
+	value = zak_confi_path_get_value (confi, "folder/key1/key1_2");
+	g_assert_cmpstr (value, ==, "value key 1 2");
+	g_free (value);
+
+	zak_confi_get_cache_stats (confi, NULL, NULL, &size);
+	g_assert_cmpuint (size, ==, 2);
+
+	/* a write isn't hidden by the cached value */
+	g_assert (zak_confi_path_set_value (confi, "folder/key2", "42"));
+	g_assert_cmpint (zak_confi_path_get_int (confi, "folder/key2", -1), ==, 42);
+	g_assert (zak_confi_path_set_value (confi, "folder/key2", "value key 2"));
+	g_assert_cmpint (zak_confi_path_get_int (confi, "folder/key2", -1), ==, -1);
+
+	zak_confi_cache_clear (confi);
+	zak_confi_get_cache_stats (confi, &hits, &misses, &size);
+	g_assert_cmpuint (hits, ==, 0);
+	g_assert_cmpuint (misses, ==, 0);
+	g_assert_cmpuint (size, ==, 0);
+
+	zak_confi_destroy (confi);
+}
+
+static void
+test_absent (void)
+{
+	ZakConfi *confi;
+	gchar *value;
+
+	confi = check_confi_new ();
+	zak_confi_set_cache_size (confi, 8);
+
+	g_assert (zak_confi_path_lookup_value (confi, "folder/absent") == NULL);
+	g_assert (zak_confi_path_lookup_value (confi, "folder/absent") == NULL);
+
+	/* the file plugin creates the key */
+	g_assert (zak_confi_path_set_value (confi, "folder/absent", "now present"));
+	value = zak_confi_path_lookup_value (confi, "folder/absent");
+	g_assert_cmpstr (value, ==, "now present");
+	g_free (value);
+
+	g_assert (zak_confi_remove_path (confi, "folder/absent"));
+
+	/* a group isn't a key, but doesn't hide its keys */
+	g_assert (zak_confi_path_get_value (confi, "folder") == NULL);
+	value = zak_confi_path_get_value (confi, "folder/key2");
+	g_assert_cmpstr (value, ==, "value key 2");
+	g_free (value);
+	g_assert (zak_confi_path_lookup_value (confi, "folder") == NULL);
+	value = zak_confi_path_lookup_value (confi, "folder/key2");
+	g_assert_cmpstr (value, ==, "value key 2");
+	g_free (value);
+
+	zak_confi_destroy (confi);
+}
+
+static void
+test_tree (void)
+{
+	ZakConfi *confi;
+	GNode *tree;
+	GNode *branch;
+	guint i;
+
+	confi = check_confi_new ();
+
+	/* run under valgrind or ASan, the loop shows the trees' leaks */
+	for (i = 0; i < 100; i++)
+		{
+			tree = zak_confi_get_tree (confi);
+			g_assert (tree != NULL);
+			g_assert (zak_confi_arena_get (tree) != NULL);
+
+			/* an unlinked branch leaves its keys to the tree */
+			branch = g_node_first_child (tree);
+			g_assert (branch != NULL);
+			g_node_unlink (branch);
+			g_assert (zak_confi_arena_get (branch) == zak_confi_arena_get (tree));
+			zak_confi_free_tree (branch);
+			zak_confi_free_tree (tree);
+
+			tree = zak_confi_get_subtree (confi, "folder", -1);
+			g_assert (tree != NULL);
+			g_assert_cmpstr (((ZakConfiKey *)tree->data)->key, ==, "folder");
+			zak_confi_free_tree (tree);
+		}
+
+	zak_confi_destroy (confi);
+}
+
+static void
+test_subtree (void)
+{
+	ZakConfi *confi;
+	GNode *tree;
+
+	confi = check_confi_new ();
+
+	/* a group containing "/" */
+	tree = zak_confi_get_subtree (confi, "folder/key2/key2-1", -1);
+	g_assert (tree != NULL);
+	g_assert_cmpstr (((ZakConfiKey *)tree->data)->value, ==, "value key 2 1");
+	zak_confi_free_tree (tree);
+
+	tree = zak_confi_get_subtree (confi, "/folder/key1/key1_2", -1);
+	g_assert (tree != NULL);
+	g_assert_cmpstr (((ZakConfiKey *)tree->data)->value, ==, "value key 1 2");
+	zak_confi_free_tree (tree);
+
+	tree = zak_confi_get_subtree (confi, "folder", -1);
+	g_assert (tree != NULL);
+	g_assert_cmpuint (g_node_n_children (tree), ==, 2);
+	zak_confi_free_tree (tree);
+
+	g_assert (zak_confi_get_subtree (confi, "folder/key1/absent", -1) == NULL);
+
+	zak_confi_destroy (confi);
+}
+
+static void
+test_iter (void)
+{
+	ZakConfi *confi;
+	ZakConfiIter *iter;
+	const gchar *path;
+	const gchar *value;
+	guint n;
+
+	const gchar *paths[] = { "/folder/key1", "/folder/key1/key1_1", "/folder/key1/key1_2",
+	                         "/folder/key2", "/folder/key2/key2-1" };
+
+	confi = check_confi_new ();
+
+	/* in path order, each path once: the key [folder] key1 hides the
+	 * group [folder/key1] */
+	iter = zak_confi_iter_new (confi, "folder");
+	g_assert (iter != NULL);
+	for (n = 0; zak_confi_iter_next (iter, &path, &value); n++)
+		{
+			g_assert_cmpuint (n, <, G_N_ELEMENTS (paths));
+			g_assert_cmpstr (path, ==, paths[n]);
+			if (n == 0)
+				{
+					g_assert_cmpstr (value, ==, "value key 1");
+				}
+		}
+	g_assert_cmpuint (n, ==, G_N_ELEMENTS (paths));
+	zak_confi_iter_free (iter);
+
+	iter = zak_confi_iter_new (confi, "absent");
+	g_assert (iter != NULL);
+	g_assert (!zak_confi_iter_next (iter, &path, &value));
+	zak_confi_iter_free (iter);
+
+	zak_confi_destroy (confi);
+}
+
+static void
+test_handle (void)
+{
+	ZakConfi *confi;
+	ZakConfiPathHandle *handle;
+	ZakConfiPathHandle *other;
+	gchar *value;
+
+	confi = check_confi_new ();
+	zak_confi_set_cache_size (confi, 8);
+
+	handle = zak_confi_path_compile (confi, "folder/key2");
+	other = zak_confi_path_compile (confi, "/folder/key1/key1_1");
+
+	value = zak_confi_handle_get_value (handle);
+	g_assert_cmpstr (value, ==, "value key 2");
+	g_free (value);
+
+	/* the write is seen through the handle, the path and the cache */
+	g_assert (zak_confi_handle_set_value (handle, "by handle"));
+	value = zak_confi_handle_get_value (handle);
+	g_assert_cmpstr (value, ==, "by handle");
+	g_free (value);
+	value = zak_confi_path_get_value (confi, "folder/key2");
+	g_assert_cmpstr (value, ==, "by handle");
+	g_free (value);
+
+	value = zak_confi_handle_get_value (other);
+	g_assert_cmpstr (value, ==, "value key 1 1");
+	g_free (value);
+
+	g_assert (zak_confi_handle_set_value (handle, "value key 2"));
+
+	/* a handle of a missing key creates it */
+	zak_confi_path_handle_free (other);
+	other = zak_confi_path_compile (confi, "folder/handle");
+	g_assert (zak_confi_path_lookup_value (confi, "folder/handle") == NULL);
+	g_assert (zak_confi_handle_set_value (other, "created"));
+	value = zak_confi_path_lookup_value (confi, "folder/handle");
+	g_assert_cmpstr (value, ==, "created");
+	g_free (value);
+	g_assert (zak_confi_remove_path (confi, "folder/handle"));
+
+	zak_confi_path_handle_free (other);
+	zak_confi_path_handle_free (handle);
+	zak_confi_destroy (confi);
+}
+
+int
+main (int argc, char **argv)
+{
+	gchar *contents;
+	gsize length;
+	gint fd;
+	gint ret;
+
+	g_test_init (&argc, &argv, NULL);
+
+	peas_engine_add_search_path (peas_engine_get_default (), "../plugins", NULL);
+
+	/* the tests write the file */
+	g_assert (g_file_get_contents (TESTS_SRCDIR "/conf.conf", &contents, &length, NULL));
+	fd = g_file_open_tmp ("zakconfi-check-XXXXXX.conf", &filename, NULL);
+	g_assert (fd >= 0);
+	g_close (fd, NULL);
+	g_assert (g_file_set_contents (filename, contents, length, NULL));
+	g_free (contents);
+
+	g_test_add_func ("/confi/cache", test_cache);
+	g_test_add_func ("/confi/absent", test_absent);
+	g_test_add_func ("/confi/tree", test_tree);
+	g_test_add_func ("/confi/subtree", test_subtree);
+	g_test_add_func ("/confi/iter", test_iter);
+	g_test_add_func ("/confi/handle", test_handle);
+
+	ret = g_test_run ();
+
+	g_unlink (filename);
+	g_free (filename);
+
+	return ret;
+}
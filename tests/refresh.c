@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2016 Andrea Zagli <azagli@libero.it>
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+/* Reads and frees the tree over and over, as a service that refreshes
+ * its configuration does: run it under
+ *   valgrind --leak-check=full ./refresh <connection string> [times]
+ * (or built with -fsanitize=address) and the leaks must not grow with
+ * the number of refreshes. It is a manual check, not run by "make check"
+ * (which runs the same loop, shorter, on a file). */
+
+#include <stdlib.h>
+
+#include <glib/gprintf.h>
+#include <libpeas/peas.h>
+
+#include <libgdaex/libgdaex.h>
+
+#include "libzakconfi.h"
+
+int
+main (int argc, char *argv[])
+{
+	PeasEngine *engine;
+	ZakConfi *confi;
+	GNode *tree;
+	guint times;
+	guint nodes;
+	guint i;
+
+	gda_init ();
+
+	if (argc < 2)
+		{
+			g_error ("Usage: refresh <connection string> [times]");
+			return 0;
+		}
+
+	times = (argc > 2 ? (guint)strtoul (argv[2], NULL, 10) : 1000);
+
+	engine = peas_engine_get_default ();
+	peas_engine_add_search_path (engine, "./plugins", NULL);
+
+	confi = zak_confi_new (argv[1]);
+	if (confi == NULL)
+		{
+			g_error ("Error on configuration initialization.");
+			return 0;
+		}
+
+	/* the configuration repeats a lot of values */
+	zak_confi_set_intern_values (confi, TRUE);
+
+	nodes = 0;
+	for (i = 0; i < times; i++)
+		{
+			tree = zak_confi_get_tree (confi);
+			if (tree == NULL)
+				{
+					g_error ("Unable to read the tree.");
+					return 0;
+				}
+			nodes = g_node_n_nodes (tree, G_TRAVERSE_ALL);
+			zak_confi_free_tree (tree);
+
+			tree = zak_confi_get_subtree (confi, "folder", -1);
+			zak_confi_free_tree (tree);
+		}
+
+	g_printf ("Tree of %u nodes read and freed %u times\n", nodes, times);
+
+	zak_confi_destroy (confi);
+
+	return 0;
+}
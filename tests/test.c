@@ -33,6 +33,49 @@ traverse_func (GNode *node,
 	return FALSE;
 }
 
+void
+changed_func (ZakConfi *confi,
+              const gchar *path,
+              gpointer user_data)
+{
+	g_printf ("Changed: %s\n", path);
+}
+
+gboolean
+foreach_func (ZakConfi *confi,
+              const gchar *path,
+              const gchar *value,
+              gpointer user_data)
+{
+	g_printf ("%s => %s\n", path, value);
+
+	return FALSE;
+}
+
+void
+path_get_value_cb (GObject *source_object,
+                   GAsyncResult *res,
+                   gpointer user_data)
+{
+	gchar *value;
+	GError *error;
+
+	error = NULL;
+	value = zak_confi_path_get_value_finish ((ZakConfi *)source_object, res, &error);
+	if (error != NULL)
+		{
+			g_printf ("Error on reading asynchronously: %s\n", error->message);
+			g_error_free (error);
+		}
+	else
+		{
+			g_printf ("Value from key \"folder/key1/key1_2\" read asynchronously\n%s\n\n", value);
+			g_free (value);
+		}
+
+	g_main_loop_quit ((GMainLoop *)user_data);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -83,8 +126,35 @@ main (int argc, char **argv)
 	g_printf ("Traversing the entire tree\n");
 	tree = zak_confi_get_tree (confi);
 	g_node_traverse (tree, G_PRE_ORDER, G_TRAVERSE_ALL, -1, traverse_func, NULL);
+	zak_confi_free_tree (tree);
+	g_printf ("\n");
+
+	g_printf ("Traversing only the branch \"folder\"\n");
+	tree = zak_confi_get_subtree (confi, "folder", -1);
+	if (tree != NULL)
+		{
+			g_node_traverse (tree, G_PRE_ORDER, G_TRAVERSE_ALL, -1, traverse_func, NULL);
+			zak_confi_free_tree (tree);
+		}
+	g_printf ("\n");
+
+	ZakConfiTree *ctree = zak_confi_get_tree_compact (confi);
+	if (ctree != NULL)
+		{
+			guint node = zak_confi_tree_lookup (ctree, "folder/key2");
+			g_printf ("Compact tree: %u nodes; value of \"folder/key2\": %s\n\n",
+			          zak_confi_tree_get_size (ctree),
+			          node != ZAK_CONFI_TREE_NONE ? zak_confi_tree_get_value (ctree, node) : "(not found)");
+			zak_confi_tree_unref (ctree);
+		}
+
+	g_printf ("Streaming the keys under \"folder\"\n");
+	zak_confi_foreach (confi, "folder", foreach_func, NULL);
 	g_printf ("\n");
 
+	gint64 revision = zak_confi_get_revision (confi);
+	gulong watch = zak_confi_watch (confi, "folder/key1", changed_func, NULL, NULL);
+
 	gchar *val = zak_confi_path_get_value (confi, "folder/key1/key1_2");
 	g_printf ("Value from key \"folder/key1/key1_2\"\n%s\n\n", val);
 	zak_confi_path_set_value (confi, "folder/key1/key1_2", "new value programmatically setted");
@@ -92,6 +162,54 @@ main (int argc, char **argv)
 	zak_confi_path_set_value (confi, "folder/key1/key1_2", val);
 	g_printf ("Value from key \"folder/key1/key1_2\"\n%s\n\n", zak_confi_path_get_value (confi, "folder/key1/key1_2"));
 
+	zak_confi_unwatch (confi, watch);
+
+	g_printf ("Value from key \"folder/key2\" as integer\n%d\n\n", zak_confi_path_get_int (confi, "folder/key2", -1));
+	g_printf ("Value from key \"folder/key2\" as boolean\n%s\n\n", zak_confi_path_get_boolean (confi, "folder/key2", FALSE) ? "true" : "false");
+	g_printf ("Optional key \"folder/missing/key\"\n%s\n\n", zak_confi_path_lookup_value (confi, "folder/missing/key") == NULL ? "not found" : "found");
+
+	ZakConfiPathHandle *handle = zak_confi_path_compile (confi, "folder/key2");
+	if (handle != NULL)
+		{
+			for (guint i = 0; i < 3; i++)
+				{
+					g_printf ("Value from compiled path \"folder/key2\"\n%s\n\n", zak_confi_handle_get_value (handle));
+				}
+			zak_confi_path_handle_free (handle);
+		}
+
+	GHashTable *changes = zak_confi_get_changes_since (confi, revision);
+	if (changes != NULL)
+		{
+			GHashTableIter iter;
+			gpointer path;
+			gpointer value;
+
+			g_printf ("Changes since revision %" G_GINT64_FORMAT "\n", revision);
+			g_hash_table_iter_init (&iter, changes);
+			while (g_hash_table_iter_next (&iter, &path, &value))
+				{
+					g_printf ("%s => %s\n", (gchar *)path, (value != NULL ? (gchar *)value : "(removed)"));
+				}
+			g_printf ("\n");
+			g_hash_table_destroy (changes);
+		}
+
+	const gchar *paths[] = { "folder/key1/key1_1", "folder/key1/key1_2", "folder/key2", "folder/missing", NULL };
+	GHashTable *values = zak_confi_paths_get_values (confi, paths);
+	g_printf ("Values from %d paths in one call\n", g_strv_length ((gchar **)paths));
+	for (guint i = 0; paths[i] != NULL; i++)
+		{
+			g_printf ("%s => %s\n", paths[i], (gchar *)g_hash_table_lookup (values, paths[i]));
+		}
+	g_printf ("\n");
+	g_hash_table_destroy (values);
+
+	GMainLoop *loop = g_main_loop_new (NULL, FALSE);
+	zak_confi_path_get_value_async (confi, "folder/key1/key1_2", NULL, path_get_value_cb, loop);
+	g_main_loop_run (loop);
+	g_main_loop_unref (loop);
+
 	zak_confi_add_key (confi, "folder/key2", "key2-2", NULL);
 	zak_confi_path_set_value (confi, "folder/key2/key2-2", "value for key2-2, programmatically setted");
 
@@ -109,6 +227,11 @@ main (int argc, char **argv)
 	g_printf ("Value from key \"key2-1\" %s\n", zak_confi_path_get_value (confi, "key2-1"));
 	g_printf ("Value from key \"folder/key1/key1_2\" (expected null) %s\n", zak_confi_path_get_value (confi, "folder/key1/key1_2"));
 
+	ZakConfiSnapshot *snapshot = zak_confi_snapshot_new (confi);
+	g_printf ("\nSnapshot with %d keys\n", zak_confi_snapshot_get_size (snapshot));
+	g_printf ("Value from key \"key2-1\" %s\n", zak_confi_snapshot_get_value (snapshot, "key2-1"));
+	zak_confi_snapshot_unref (snapshot);
+
 	zak_confi_destroy (confi);
 
 	return 0;